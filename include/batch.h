@@ -0,0 +1,54 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "headless.h"
+
+// Runs always made before the precision target may stop a batch early
+#define BATCH_MIN_RUNS 30
+
+// Streaming mean/variance (Welford), constant memory regardless of run count
+typedef struct {
+    long long count;
+    double mean;
+    double m2;
+    double min;
+    double max;
+} RunningStat;
+
+// Batch runner options
+typedef struct {
+    long long max_runs;        // Upper bound on the number of simulations
+    int num_workers;           // Worker processes (0 = one per CPU)
+    uint64_t base_seed;        // Run i is seeded with base_seed + i
+    double target_precision;   // Stop once the 95% CI half-width of P(police win) is below this (0 = off)
+} BatchOptions;
+
+// Aggregated results of a batch
+typedef struct {
+    long long runs;
+    long long outcome_counts[NUM_OUTCOMES];
+    RunningStat time_units;            // Simulated time to termination
+    RunningStat successful_missions;
+    RunningStat thwarted_missions;
+    RunningStat executed_agents;
+    RunningStat agents_remaining;
+    RunningStat agent_survival;        // Fraction of agents not executed, per run
+    bool stopped_early;
+} BatchSummary;
+
+// Function prototypes
+void running_stat_init(RunningStat* stat);
+void running_stat_add(RunningStat* stat, double value);
+double running_stat_stddev(const RunningStat* stat);
+double running_stat_ci95(const RunningStat* stat);
+void proportion_ci95(long long successes, long long trials, double* low, double* high);
+void batch_summary_init(BatchSummary* summary);
+void batch_summary_add(BatchSummary* summary, HeadlessResult result);
+void run_seeded_simulation(SimulationConfig config, uint64_t seed, HeadlessResult* result);
+BatchSummary run_batch(SimulationConfig config, BatchOptions options);
+void print_batch_summary(BatchSummary summary);
+
+#endif /* BATCH_H */
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 // Crime types enum
 typedef enum {
@@ -17,6 +19,25 @@ typedef enum {
     NUM_CRIME_TYPES
 } CrimeType;
 
+// How members exchange information each tick (EXCHANGE_MODEL)
+typedef enum {
+    EXCHANGE_PAIRWISE,    // One truth/false draw per pair of members, O(members)
+    EXCHANGE_HISTOGRAM    // One binomial draw per rank, O(ranks)
+} ExchangeModel;
+
+// Where the shared simulation state lives (SHM_BACKEND)
+typedef enum {
+    SHM_BACKEND_SYSV,     // shmget/shmat on a fixed key
+    SHM_BACKEND_POSIX     // shm_open/mmap on a name unique to the run
+} ShmBackend;
+
+// Huge pages for the POSIX backend (SHM_HUGE_PAGES)
+typedef enum {
+    SHM_HUGE_PAGES_NONE,
+    SHM_HUGE_PAGES_TRANSPARENT,   // Ask for transparent huge pages with madvise
+    SHM_HUGE_PAGES_EXPLICIT       // Reserved huge pages (hugetlb), else transparent
+} ShmHugePages;
+
 // Configuration structure to hold all user-defined parameters
 typedef struct {
     // Gang configuration
@@ -39,6 +60,8 @@ typedef struct {
     int police_action_threshold;
     int truth_gain;        // Knowledge gain when receiving truthful information
     int false_penalty;     // Knowledge penalty when receiving false information
+    ExchangeModel exchange_model;
+    double evidence_half_life;  // Time units for the weight of a police report to halve
     
     // Mission outcomes
     int mission_success_rate_base;
@@ -51,12 +74,47 @@ typedef struct {
     int max_successful_plans;
     int max_executed_agents;
     
+    // Random numbers
+    unsigned long long seed;   // Run seed; 0 picks one from the clock
+    
+    // Simulation clock
+    double time_scale;     // Simulated time units per wall-clock unit (1.0 = real time)
+    
     // Visualization
     int visualization_refresh_rate;
+    
+    // Shared memory
+    ShmBackend shm_backend;
+    bool shm_prefault;            // Fault the whole POSIX segment in when mapping it
+    ShmHugePages shm_huge_pages;
 } SimulationConfig;
 
+// Parameter sweeps (see load_sweep)
+#define SWEEP_MAX_AXES 8
+
+// One swept configuration key
+typedef struct {
+    char key[64];      // Config file key, e.g. FALSE_INFO_PROBABILITY
+    double min;
+    double max;
+    double step;       // 0 for a continuous (sample-only) axis
+} SweepAxis;
+
+// A sweep over up to SWEEP_MAX_AXES configuration keys
+typedef struct {
+    int num_axes;
+    SweepAxis axes[SWEEP_MAX_AXES];
+    long long num_samples;   // Random points to draw; 0 sweeps the full grid
+    int runs_per_point;      // Simulations per point
+} SweepSpec;
+
 // Function prototypes
 SimulationConfig load_config(const char* config_file);
+bool set_config_value(SimulationConfig* config, const char* key, const char* value);
+bool load_sweep(const char* config_file, SweepSpec* spec);
+long long sweep_num_points(const SweepSpec* spec);
+void sweep_point_values(const SweepSpec* spec, long long index, uint64_t seed, double* values);
+SimulationConfig sweep_point_config(SimulationConfig base, const SweepSpec* spec, const double* values);
 void print_config(SimulationConfig config);
 
 #endif /* CONFIG_H */
@@ -2,68 +2,161 @@
 #define GANG_H
 
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include "config.h"
+#include "utils.h"
 
-// Gang member structure
+// Defined in police.h, ipc.h and task_pool.h
+struct IntelligenceReport;
+struct SharedState;
+struct TaskPool;
+
+// Duration of each simulated activity, in simulation time units (see sim_clock.h)
+#define MEMBER_TICK_UNITS 1        // One member preparation/knowledge exchange step
+#define PREPARATION_STEP_UNITS 1   // One unit of a mission's preparation_time
+#define PRISON_STEP_UNITS 1        // One unit of a prison term
+#define GANG_STEP_DONE -1          // Returned by gang_process_step when the simulation is over
+#define INVESTIGATION_TOP_K 3      // Suspects interrogated per investigation
+#define SUSPECT_SCORE_THRESHOLD 30 // Members scoring above this are suspects
+
+// Member attributes stored as one array per field, indexed by member id, so
+// loops over the whole gang read contiguous memory for the fields they use.
+// The atomic fields are each member's own progress: outside a mission
+// transition only that member's tick writes them, and other threads may read
+// them at any time. The other fields change only during mission transitions.
+// A tick makes the member's seq odd while it writes, so readers can copy the
+// progress fields of one member consistently (see gang_snapshot_members).
+typedef struct {
+    atomic_uint* seq;
+    int* rank;
+    atomic_int* preparation_level;
+    atomic_int* knowledge;       // Knowledge about current mission
+    int* suspicion;              // How suspicious the member appears; written under the suspect heap lock
+    atomic_int* knowledge_rate;
+    bool* is_secret_agent;
+    bool* alive;          // Whether the member is alive
+    bool* in_prison;      // Whether the member is in prison
+} MemberStore;
+
+// Consistent copy of one member, taken by gang_snapshot_members
 typedef struct {
-    int id;
-    int rank;
     int preparation_level;
-    int knowledge;    // Knowledge about current mission
-    int suspicion;    // How suspicious the member appears
-    bool is_secret_agent;
-    bool alive;       // Whether the member is alive
-    bool in_prison;   // Whether the member is in prison
+    int knowledge;
     int knowledge_rate;
-    pthread_t thread;
-    void* gang_ptr;  // Pointer back to the gang
-} GangMember;
+    int rank;
+    bool is_secret_agent;
+    bool is_active;
+} MemberSnapshot;
+
+// Members ordered by suspicion, most suspicious first and earlier members
+// first among equal scores. A score only changes when a member crosses one
+// of the scoring thresholds, so member ticks rarely take the lock.
+typedef struct {
+    pthread_mutex_t lock;
+    int* members;        // Member ids in heap order
+    int* position;       // Index of each member in members
+    int num_suspects;    // Members scoring above SUSPECT_SCORE_THRESHOLD
+} SuspectHeap;
 
 // Gang structure
 typedef struct {
     int id;
     int num_members;
     int num_ranks;
-    GangMember* members;
+    MemberStore member_data;  // Member attributes
+    RngStream* member_streams;  // One random stream per member, keyed like a member thread's
     
     // Gang state
     CrimeType current_target;
     int preparation_time;
     int required_preparation_level;
-    bool is_active;
-    bool is_in_prison;
+    atomic_llong total_preparation;  // Sum of members' preparation_level, kept in step with them
+    atomic_bool is_active;
+    atomic_bool is_in_prison;
     int prison_time_remaining;
     int false_info_probability;
     int truth_gain;        // Knowledge gain when receiving truthful information
     int false_penalty;     // Knowledge penalty when receiving false information
     
+    // Truth probabilities for the knowledge exchange, as probability_threshold
+    // values indexed by [sender_rank * num_ranks + receiver_rank]. Rebuilt by
+    // refresh_truth_table when false_info_probability or num_ranks changes.
+    uint32_t* truth_table;
+    int truth_table_ranks;
+    int truth_table_false_info;
+    
+    // Knowledge exchange model, and for EXCHANGE_HISTOGRAM the number of
+    // alive, free members of each rank. Kept current by initialize_gang_state
+    // and replace_member; anything else that changes a member's rank, alive
+    // or in_prison must update it too.
+    ExchangeModel exchange_model;
+    int* active_by_rank;
+    
+    SuspectHeap suspects;
+    int num_agents;              // Secret agents among the members
+    
     // Statistics
     int successful_missions;
     int thwarted_missions;
     int executed_agents;
     
-    // Synchronization
+    // Synchronization. Member ticks take no lock. Mission transitions
+    // (planning, executing, investigating) hold gang_mutex and keep
+    // mission_version odd while they run; a tick only proceeds while the
+    // version is even, and a transition first waits for active_ticks to
+    // drain, so ticks always see a consistent current_target,
+    // required_preparation_level and member table.
     pthread_mutex_t gang_mutex;
-    pthread_cond_t gang_cond;
+    atomic_uint mission_version;    // Also a futex word ticks sleep on during a transition
+    atomic_uint active_ticks;       // Also a futex word the transition sleeps on
     
     // IPC
     int report_queue_id;
+    bool publish_preparation;  // Publish progress in the gang status slot for the visualizer
+    struct TaskPool* pool;     // Runs member ticks; NULL when driven by the headless engine
     
     // Process ID
     pid_t pid;
 } Gang;
 
+// Mission bookkeeping kept by the gang process between loop iterations
+typedef struct {
+    int time_spent_preparing;
+    bool mission_planned;
+} GangSchedule;
+
 // Function prototypes
-void initialize_gang(Gang* gang, int id, int num_members, int num_ranks, SimulationConfig config);
-void* gang_member_routine(void* arg);
+void initialize_gang(Gang* gang, int id, int num_members, int num_ranks, int num_gangs,
+                     int report_queue_id, SimulationConfig config);
+void initialize_gang_state(Gang* gang, int id, int num_members, int num_ranks, SimulationConfig config);
+bool gang_member_tick(Gang* gang, int member_id, struct IntelligenceReport* report);
+int gang_process_step(Gang* gang, GangSchedule* schedule, struct SharedState* shm, SimulationConfig config);
 void* gang_leader_routine(void* arg);
 void plan_new_mission(Gang* gang, SimulationConfig config);
 void execute_mission(Gang* gang, SimulationConfig config);
 void investigate_for_agents(Gang* gang, SimulationConfig config);
+void begin_mission_transition(Gang* gang);
+void end_mission_transition(Gang* gang);
+void replace_member(Gang* gang, int member_id, SimulationConfig config);
+unsigned int gang_snapshot_members(Gang* gang, MemberSnapshot* snapshots);
+int gang_average_preparation(Gang* gang);
 void cleanup_gang(Gang* gang);
 
 // Helper function to determine if truth or disinformation is delivered based on rank difference
 bool deliver_truth(int sender_rank, int receiver_rank, int false_info_probability);
+int truth_probability(int sender_rank, int receiver_rank, int false_info_probability);
+void refresh_truth_table(Gang* gang);
+
+// Whether a member can currently take part in the knowledge exchange
+static inline bool member_is_active(const Gang* gang, int member_id) {
+    return gang->member_data.alive[member_id] && !gang->member_data.in_prison[member_id];
+}
+
+// Whether a member is a secret agent
+static inline bool member_is_agent(const Gang* gang, int member_id) {
+    return gang->member_data.is_secret_agent[member_id];
+}
 
 #endif /* GANG_H */
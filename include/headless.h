@@ -0,0 +1,37 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <stdbool.h>
+#include "config.h"
+
+// Upper bound on simulated time for runs that never reach a termination condition
+#define HEADLESS_MAX_VIRTUAL_MS (7LL * 24 * 60 * 60 * 1000)
+
+// How a simulation ended
+typedef enum {
+    OUTCOME_GANGS_WIN,    // Gangs reached max_successful_plans
+    OUTCOME_POLICE_WIN,   // Police reached max_thwarted_plans
+    OUTCOME_AGENTS_LOST,  // Gangs executed max_executed_agents
+    OUTCOME_TIMEOUT,      // No termination condition within HEADLESS_MAX_VIRTUAL_MS
+    NUM_OUTCOMES
+} SimulationOutcome;
+
+// Summary of a headless run
+typedef struct {
+    SimulationOutcome outcome;
+    long long virtual_time_ms;     // Simulated time at termination
+    long long events_processed;
+    int num_gangs;
+    int total_members;
+    int successful_missions;
+    int thwarted_missions;
+    int executed_agents;
+    int agents_remaining;          // Undiscovered secret agents at termination
+} HeadlessResult;
+
+// Function prototypes
+HeadlessResult run_headless_simulation(SimulationConfig config, bool verbose);
+void print_headless_result(HeadlessResult result);
+const char* outcome_to_string(SimulationOutcome outcome);
+
+#endif /* HEADLESS_H */
@@ -1,54 +1,167 @@
 #ifndef IPC_H
 #define IPC_H
 
+#include <stdatomic.h>
+#include <stdint.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
-#include <sys/msg.h>
 #include <sys/shm.h>
-#include <sys/sem.h>
 #include "police.h"
+#include "sim_clock.h"
 
-// Define keys for IPC resources
-#define REPORT_QUEUE_KEY 0x1234
-#define SHARED_MEMORY_KEY 0x5678
-#define SEMAPHORE_KEY 0x9ABC
+// Shared structures written by different processes are aligned to this so
+// that no two writers share a cache line
+#define CACHE_LINE_SIZE 64
 
-// Message queue structure for intelligence reports
+// Reports the report ring holds; a power of two
+#define REPORT_RING_CAPACITY 4096
+
+// One intelligence report in the ring, in fixed-width fields. sequence
+// tells whose turn the slot is: it equals the ticket of the producer that
+// may fill it, and that ticket + 1 once the report is published.
+typedef struct {
+    int64_t time_ms;
+    atomic_uint sequence;
+    int32_t gang_id;
+    int32_t agent_id;
+    int16_t suspicion_level;
+    uint8_t suspected_target;
+    uint8_t is_reliable;
+} ReportSlot;
+
+// Multi-producer, single-consumer ring of intelligence reports in its own
+// shared memory segment. Gang threads claim tickets from tail and the police
+// process alone advances head, each on its own cache line. The police sets
+// consumer_waiting before it sleeps on the wakeups futex, so producers only
+// make a system call when it is asleep. end_simulation sets closed and bumps
+// wakeups, so a sleeping police wakes for shutdown as well as for reports.
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint tail;
+    atomic_uint dropped;            // Reports refused because the ring was full
+    _Alignas(CACHE_LINE_SIZE) atomic_uint head;
+    atomic_uint consumer_waiting;
+    atomic_uint wakeups;
+    atomic_uint closed;             // Set once the simulation has ended
+    _Alignas(CACHE_LINE_SIZE) ReportSlot slots[REPORT_RING_CAPACITY];
+} ReportRing;
+
+// Where a gang stands, as published by its process for the visualizer
+typedef struct {
+    int preparation_level;       // Average member preparation, percent
+    CrimeType current_target;
+    int num_members;
+    int num_agents;
+    bool in_prison;
+    int prison_time_remaining;
+} GangProgress;
+
+// Orders the police gives one gang; only the police process writes here.
+// An arrest sets prison_time and then bumps arrests; the gang notices it by
+// comparing arrests with its own arrests_seen.
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_uint arrests;
+    atomic_int prison_time;
+} GangCommand;
+
+// State of one gang, written only by the gang's own process: its share of
+// the simulation totals, the last arrest it acted on and its progress. The
+// gang makes progress_seq odd while it writes the progress fields; readers
+// retry until they see the same even value before and after (see
+// read_gang_progress). progress_seq stays 0 until the gang first publishes.
+typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_int successful_missions;
+    atomic_int thwarted_missions;
+    atomic_int executed_agents;
+    atomic_uint arrests_seen;
+    
+    atomic_uint progress_seq;
+    atomic_int preparation_level;
+    atomic_int current_target;
+    atomic_int num_members;
+    atomic_int num_agents;
+    atomic_bool in_prison;
+    atomic_int prison_time_remaining;
+} GangStatus;
+
+// Everything shared about one gang, with the police's and the gang's halves
+// on separate cache lines
+typedef struct {
+    GangCommand command;
+    GangStatus status;
+} GangSlot;
+
+// The police process's share of the simulation totals; only it writes here
 typedef struct {
-    long mtype;  // Message type
-    IntelligenceReport report;
-} ReportMessage;
+    _Alignas(CACHE_LINE_SIZE) atomic_int thwarted_missions;   // Missions stopped by arrests
+} PoliceRegion;
 
-// Shared memory structure for simulation state
+// Outcomes claimed against the termination limits (see claim_outcomes).
+// Every process writes here, but only when a mission ends or agents are
+// executed, never on the per-tick paths.
 typedef struct {
+    _Alignas(CACHE_LINE_SIZE) atomic_int successful_missions;
+    atomic_int thwarted_missions;
+    atomic_int executed_agents;
+} OutcomeClaims;
+
+// Sums of the per-writer counters (see shared_totals)
+typedef struct {
+    int successful_missions;
+    int thwarted_missions;
+    int executed_agents;
+} SharedTotals;
+
+// Shared memory structure for simulation state: a read-mostly header, the
+// police region, the outcome claims and one GangSlot per gang. Every police
+// and gang counter has a single writer, so no process ever locks the
+// segment and no two processes write the same cache line on the hot paths.
+// A writer first claims the outcome it is about to count, so no total
+// passes its limit, then bumps its counter and calls
+// check_simulation_limits, so the process that reaches a limit ends the
+// simulation. The segment is sized for num_gangs when it is created (see
+// shared_state_size); use shared_gang_slot to index it.
+typedef struct SharedState {
     int num_gangs;
-    int total_successful_missions;
-    int total_thwarted_missions;
-    int total_executed_agents;
-    bool simulation_running;
     
-    // Gang arrest status - used for police to communicate with gangs
-    struct {
-        bool is_arrested;
-        int prison_time;
-        bool arrest_notification_seen;
-    } gang_status[100]; // Assuming max 100 gangs
+    // 0 while the simulation runs and 1 once it has ended; also the futex
+    // word that end_simulation wakes every waiting process on
+    atomic_uint ended;
+    
+    // Virtual simulation clock read by every process
+    SimClock clock;
+    
+    PoliceRegion police;
+    
+    OutcomeClaims claims;
+    
+    // num_gangs entries
+    GangSlot gangs[];
 } SharedState;
 
 // Function prototypes
-int create_report_queue();
+int create_report_queue(void);
 void destroy_report_queue(int queue_id);
 int send_report(int queue_id, IntelligenceReport report);
 int receive_report(int queue_id, IntelligenceReport* report);
+int receive_report_timed(int queue_id, IntelligenceReport* report, int timeout_ms);
+int receive_reports_timed(int queue_id, IntelligenceReport* reports, int max_reports, int timeout_ms);
 
-int create_shared_memory();
+size_t shared_state_size(int num_gangs);
+void init_shared_state(SharedState* shm, int num_gangs);
+GangSlot* shared_gang_slot(SharedState* shm, int gang_id);
+SharedTotals shared_totals(SharedState* shm);
+bool shared_limits_reached(SharedState* shm, SimulationConfig config);
+bool simulation_has_ended(SharedState* shm);
+void end_simulation(SharedState* shm);
+int claim_outcomes(SharedState* shm, atomic_int* claimed, int count, int limit);
+bool check_simulation_limits(SharedState* shm, SimulationConfig config);
+bool wait_for_simulation_end(SharedState* shm, int timeout_ms);
+void publish_gang_progress(GangStatus* status, const GangProgress* progress);
+bool read_gang_progress(GangStatus* status, GangProgress* progress);
+int create_shared_memory(int num_gangs, SimulationConfig config);
+int find_shared_memory(void);
 void destroy_shared_memory(int shm_id);
 SharedState* attach_shared_memory(int shm_id);
 void detach_shared_memory(SharedState* shm_ptr);
 
-int create_semaphore_set();
-void destroy_semaphore_set(int sem_id);
-void semaphore_wait(int sem_id, int sem_num);
-void semaphore_signal(int sem_id, int sem_num);
-
 #endif /* IPC_H */
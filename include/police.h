@@ -7,33 +7,104 @@
 #include "config.h"
 #include "gang.h"
 
+struct SharedState;
+
+// Simulation time units between police monitoring passes over accumulated reports
+#define POLICE_ANALYSIS_UNITS 2
+
+// Longest wait for a report before the police process rechecks whether the
+// simulation is still running, in wall-clock milliseconds. Only a safety
+// net: the end of the simulation wakes the wait directly.
+#define POLICE_INTAKE_TIMEOUT_MS 1000
+
+// Most reports the police process takes from the queue per wakeup
+#define POLICE_INTAKE_BATCH 256
+
+// Reports kept per gang; once full, the oldest report is dropped
+#define POLICE_REPORTS_PER_GANG 64
+
+// Reports older than this many evidence half-lives (weight below 1/32)
+// leave the evidence window
+#define EVIDENCE_WINDOW_HALF_LIVES 5
+
 // Information structure passed from agents to police
-typedef struct {
+typedef struct IntelligenceReport {
     int gang_id;
     int agent_id;
     CrimeType suspected_target;
     int suspicion_level;
     bool is_reliable;
+    long long time_ms;   // Simulation time the report was sent
 } IntelligenceReport;
 
+// Reports about one gang, as a ring buffer in a chunk of
+// POLICE_REPORTS_PER_GANG reports taken from the police report pool
+typedef struct {
+    IntelligenceReport* items;   // NULL while the gang has no reports
+    int head;                    // Oldest report
+    int count;                   // Reports inside the evidence window
+    unsigned long newest_seq;    // Arrival number of the newest report
+    
+    // Evidence over the stored reports as of evidence_time_ms, each report
+    // weighted 2^(-age / half-life). Kept in step as reports are stored,
+    // leave the window and are cleared.
+    long long evidence_time_ms;
+    double weight;               // Decayed report count
+    double suspicion;            // Decayed suspicion sum
+    double reliable;             // Decayed reliable report count
+    double crime_weight[NUM_CRIME_TYPES];
+    
+    // Set when reports are stored, expire or are cleared; the analysis of
+    // a gang is only logged once per change. Only logging depends on it:
+    // evidence decays continuously, so every gang with reports is aged on
+    // every pass either way.
+    bool analysis_unlogged;
+    bool pending_decision;       // Mentioned in the batch police_handle_reports is processing
+} GangReports;
+
+// Free list of report chunks. Chunks are carved from slabs that are only
+// released by cleanup_police, so clearing and refilling a gang's reports
+// never goes back to the allocator.
+typedef struct {
+    IntelligenceReport** free_chunks;
+    int num_free;
+    void** slabs;
+    int num_slabs;
+    int slab_capacity;
+} ReportPool;
+
 // Police structure
 typedef struct {
-    // Intelligence reports
-    IntelligenceReport* reports;
-    int report_capacity;
-    int num_reports;
+    // Intelligence reports, indexed by gang id and grown to the highest
+    // gang id seen
+    GangReports* gang_reports;
+    int gang_reports_capacity;
+    int num_reports;             // Across all gangs
+    unsigned long report_seq;    // Arrival number of the last stored report
+    ReportPool report_pool;
+    
+    // Evidence decay, from EVIDENCE_HALF_LIFE (0 disables decay)
+    double half_life_ms;
+    long long window_ms;
+    
+    // Current simulation time for the headless engine; -1 reads the shared
+    // simulation clock
+    long long virtual_now_ms;
     
     // Statistics
     int thwarted_missions;
     int total_agents;
-    int lost_agents;
     
     // Synchronization
     pthread_mutex_t police_mutex;
     pthread_cond_t police_cond;
     
     // IPC mechanism for reports from agents
-    int report_queue_id;  // Message queue ID
+    int report_queue_id;  // Report ring segment ID (see ipc.h)
+    
+    // Shared simulation state used for arrests and counters. When NULL it is
+    // looked up by key.
+    struct SharedState* shared_state;
 } Police;
 
 // Function prototypes
@@ -42,6 +113,9 @@ void process_intelligence(Police* police, IntelligenceReport report, SimulationC
 bool decide_on_action(Police* police, int gang_id, SimulationConfig config);
 void arrest_gang_members(Police* police, int gang_id, SimulationConfig config);
 void submit_report(IntelligenceReport report, int queue_id);
+void police_handle_report(Police* police, IntelligenceReport report, SimulationConfig config);
+void police_handle_reports(Police* police, const IntelligenceReport* reports, int num_reports, SimulationConfig config);
+void police_routine_step(Police* police, SimulationConfig config);
 void* police_routine(void* arg);
 void cleanup_police(Police* police);
 
@@ -0,0 +1,39 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+
+// Kinds of events driven by the discrete-event scheduler
+typedef enum {
+    EVENT_MEMBER_TICK,     // A gang member prepares and exchanges knowledge
+    EVENT_GANG_STEP,       // One iteration of a gang's process loop
+    EVENT_POLICE_ROUTINE,  // One police monitoring pass
+    NUM_EVENT_TYPES
+} EventType;
+
+// A scheduled event; ties on time are broken by insertion order
+typedef struct {
+    long long time;       // Virtual time in ms
+    unsigned long seq;    // Insertion sequence number
+    EventType type;
+    int gang_id;
+    int member_id;
+} SimEvent;
+
+// Binary min-heap of events ordered by (time, seq)
+typedef struct {
+    SimEvent* events;
+    int size;
+    int capacity;
+    unsigned long next_seq;
+} EventQueue;
+
+// Function prototypes
+void event_queue_init(EventQueue* queue, int capacity);
+void event_queue_push(EventQueue* queue, long long time, EventType type, int gang_id, int member_id);
+bool event_queue_pop(EventQueue* queue, SimEvent* event);
+bool event_queue_peek(const EventQueue* queue, SimEvent* event);
+bool event_queue_empty(const EventQueue* queue);
+void event_queue_destroy(EventQueue* queue);
+
+#endif /* SCHEDULER_H */
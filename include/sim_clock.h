@@ -0,0 +1,40 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Length of one simulation time unit in wall-clock ms at a time scale of 1x.
+// Preparation steps, prison terms and police analysis are all expressed in
+// these units so they mean the same thing in every process.
+#define SIM_TIME_UNIT_MS 1000
+
+// Limits for the runtime speed control
+#define SIM_CLOCK_MIN_SCALE 0.125
+#define SIM_CLOCK_MAX_SCALE 1000.0
+
+// Longest single wall-clock sleep, so speed changes take effect promptly
+#define SIM_CLOCK_MAX_SLEEP_MS 1000
+
+// Virtual simulation clock, shared by all processes through shared memory.
+// Simulated time advances time_scale times faster than the monotonic clock;
+// on every scale change the clock is re-anchored so time never jumps.
+// Readers use the sequence counter as a seqlock; an odd value means a
+// writer is updating the anchor.
+typedef struct {
+    atomic_uint sequence;
+    _Atomic double time_scale;
+    _Atomic long long anchor_wall_ns;   // Monotonic time of the last re-anchor
+    _Atomic long long anchor_sim_ns;    // Simulated time at the last re-anchor
+} SimClock;
+
+// Function prototypes
+void sim_clock_init(SimClock* clock, double time_scale);
+void sim_clock_attach(SimClock* clock);
+long long sim_clock_now_ms(void);
+double sim_clock_get_scale(void);
+void sim_clock_set_scale(double time_scale);
+void sim_clock_sleep_units(int units);
+void sim_clock_sleep_units_until(int units, atomic_uint* stop);
+
+#endif /* SIM_CLOCK_H */
@@ -0,0 +1,19 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "config.h"
+
+// Sweep runner options
+typedef struct {
+    int num_workers;          // Worker processes (0 = one per CPU)
+    uint64_t base_seed;       // Seeds point sampling and every simulation run
+    FILE* output;             // CSV destination, one row per point
+    bool show_progress;       // Print progress to stderr
+} SweepOptions;
+
+// Function prototypes
+long long run_sweep(SimulationConfig base, const SweepSpec* spec, SweepOptions options);
+
+#endif /* SWEEP_H */
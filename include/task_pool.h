@@ -0,0 +1,60 @@
+#ifndef TASK_POOL_H
+#define TASK_POOL_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "scheduler.h"
+
+// Runs one event on a worker thread
+typedef void (*TaskHandlerFn)(const SimEvent* event, void* ctx);
+
+// Ready events of one worker. The owner pushes and pops at the tail;
+// idle workers steal from the head.
+typedef struct {
+    pthread_mutex_t lock;
+    SimEvent* items;
+    int head;
+    int count;
+    int capacity;
+} TaskDeque;
+
+struct TaskPool;
+
+typedef struct {
+    struct TaskPool* pool;
+    int index;
+    pthread_t thread;
+    TaskDeque deque;
+} TaskWorker;
+
+// Work-stealing pool that runs simulation events on a fixed set of threads.
+// Events are ready (in a worker deque), delayed (in the timer heap until
+// their simulation time is reached) or parked (until task_pool_unpark).
+typedef struct TaskPool {
+    int num_workers;
+    TaskWorker* workers;
+    TaskHandlerFn handler;
+    void* ctx;
+    atomic_int num_ready;        // Events in all deques
+    atomic_uint next_worker;     // Round-robin target for submissions from outside the pool
+    
+    // Protected by lock (except stop)
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    EventQueue timers;           // Delayed events, by simulation time in ms
+    SimEvent* parked;
+    int num_parked;
+    int parked_capacity;
+    atomic_bool stop;            // Set by task_pool_shutdown; read without the lock
+} TaskPool;
+
+// Function prototypes
+void task_pool_init(TaskPool* pool, int num_workers, TaskHandlerFn handler, void* ctx);
+void task_pool_submit(TaskPool* pool, EventType type, int gang_id, int member_id);
+void task_pool_schedule(TaskPool* pool, long long time, EventType type, int gang_id, int member_id);
+void task_pool_park(TaskPool* pool, const SimEvent* event);
+void task_pool_unpark(TaskPool* pool, int gang_id);
+void task_pool_shutdown(TaskPool* pool);
+
+#endif /* TASK_POOL_H */
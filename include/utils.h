@@ -4,15 +4,40 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include <time.h>
 #include <sys/time.h>
+#include <stdint.h>
 #include "config.h"
 
+// Stream identifiers for rng_stream_init/rng_seed_thread. Gang streams use
+// the gang id and member id; these mark the non-member actors.
+#define RNG_PROCESS_STREAM -1   // Main process, or a gang's own (non-member) stream as member id
+#define RNG_POLICE_STREAM -2    // Police; member id 0 for report handling, 1 for the monitoring routine
+
+// Counter-based random stream
+typedef struct {
+    uint64_t key;       // Derived from (seed, gang id, member id)
+    uint64_t counter;   // Index of the next output
+} RngStream;
+
 // Function prototypes
+void rng_stream_init(RngStream* stream, uint64_t seed, int gang_id, int member_id);
+uint64_t rng_next(RngStream* stream);
+void rng_set_seed(uint64_t seed);
+uint64_t rng_get_seed(void);
+void rng_seed_thread(int gang_id, int member_id);
+void rng_use_stream(RngStream* stream);
 int random_int(int min, int max);
 double random_double(double min, double max);
 bool random_event(int probability_percentage);
+uint32_t probability_threshold(int probability_percentage);
+int random_binomial(int n, double p);
+void random_events_fill(const uint32_t* restrict thresholds, uint8_t* restrict outcomes, int n);
 void delay_ms(int milliseconds);
+int futex_wait(atomic_uint* word, unsigned int expected, const struct timespec* timeout);
+void futex_wake(atomic_uint* word, int waiters);
+void set_logging_enabled(bool enabled);
 void log_message(const char* format, ...);
 const char* crime_type_to_string(CrimeType type);
 
@@ -0,0 +1,23 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Runs one task in a worker process and writes its fixed-size result
+typedef void (*WorkerTaskFn)(long long index, void* result, void* ctx);
+
+// Called in the parent for every completed task, in completion order.
+// Returning false stops handing out new tasks (tasks already running finish
+// and are still delivered).
+typedef bool (*WorkerResultFn)(long long index, const void* result, void* ctx);
+
+// Maximum result size; results travel through a pipe and must be written atomically
+#define WORKER_MAX_RESULT_SIZE 4000
+
+// Function prototypes
+int default_worker_count(void);
+long long run_worker_pool(int num_workers, long long num_tasks, size_t result_size,
+                          WorkerTaskFn task, WorkerResultFn on_result, void* ctx);
+
+#endif /* WORKER_POOL_H */
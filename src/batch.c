@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/batch.h"
+#include "../include/worker_pool.h"
+#include "../include/sim_clock.h"
+#include "../include/utils.h"
+
+// z value for a two-sided 95% confidence interval
+#define Z_95 1.959964
+
+// Reset a running statistic
+void running_stat_init(RunningStat* stat) {
+    memset(stat, 0, sizeof(*stat));
+}
+
+// Add one sample to a running statistic
+void running_stat_add(RunningStat* stat, double value) {
+    stat->count++;
+    if (stat->count == 1) {
+        stat->min = value;
+        stat->max = value;
+    } else {
+        if (value < stat->min) stat->min = value;
+        if (value > stat->max) stat->max = value;
+    }
+    
+    double delta = value - stat->mean;
+    stat->mean += delta / stat->count;
+    stat->m2 += delta * (value - stat->mean);
+}
+
+// Sample standard deviation
+double running_stat_stddev(const RunningStat* stat) {
+    if (stat->count < 2) {
+        return 0.0;
+    }
+    return sqrt(stat->m2 / (stat->count - 1));
+}
+
+// Half-width of the 95% confidence interval of the mean (normal approximation)
+double running_stat_ci95(const RunningStat* stat) {
+    if (stat->count < 2) {
+        return 0.0;
+    }
+    return Z_95 * running_stat_stddev(stat) / sqrt((double)stat->count);
+}
+
+// Wilson score 95% interval for a proportion
+void proportion_ci95(long long successes, long long trials, double* low, double* high) {
+    if (trials == 0) {
+        *low = 0.0;
+        *high = 1.0;
+        return;
+    }
+    
+    double n = (double)trials;
+    double p = successes / n;
+    double z2 = Z_95 * Z_95;
+    double center = (p + z2 / (2 * n)) / (1 + z2 / n);
+    double half = Z_95 * sqrt(p * (1 - p) / n + z2 / (4 * n * n)) / (1 + z2 / n);
+    
+    *low = center - half;
+    *high = center + half;
+}
+
+// Reset a batch summary
+void batch_summary_init(BatchSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    running_stat_init(&summary->time_units);
+    running_stat_init(&summary->successful_missions);
+    running_stat_init(&summary->thwarted_missions);
+    running_stat_init(&summary->executed_agents);
+    running_stat_init(&summary->agents_remaining);
+    running_stat_init(&summary->agent_survival);
+}
+
+// Fold one run into a batch summary
+void batch_summary_add(BatchSummary* summary, HeadlessResult result) {
+    summary->runs++;
+    summary->outcome_counts[result.outcome]++;
+    
+    running_stat_add(&summary->time_units, result.virtual_time_ms / (double)SIM_TIME_UNIT_MS);
+    running_stat_add(&summary->successful_missions, result.successful_missions);
+    running_stat_add(&summary->thwarted_missions, result.thwarted_missions);
+    running_stat_add(&summary->executed_agents, result.executed_agents);
+    running_stat_add(&summary->agents_remaining, result.agents_remaining);
+    
+    int agents_seen = result.agents_remaining + result.executed_agents;
+    if (agents_seen > 0) {
+        running_stat_add(&summary->agent_survival, (double)result.agents_remaining / agents_seen);
+    }
+}
+
+// Run one headless simulation from a fixed seed
+void run_seeded_simulation(SimulationConfig config, uint64_t seed, HeadlessResult* result) {
+    rng_set_seed(seed);
+    *result = run_headless_simulation(config, false);
+}
+
+// State shared by the batch task and result callbacks
+typedef struct {
+    SimulationConfig config;
+    BatchOptions options;
+    BatchSummary summary;
+} BatchContext;
+
+// Worker side: run simulation number index
+static void batch_task(long long index, void* result, void* ctx) {
+    BatchContext* batch = (BatchContext*)ctx;
+    run_seeded_simulation(batch->config, batch->options.base_seed + (uint64_t)index,
+                          (HeadlessResult*)result);
+}
+
+// Parent side: aggregate a finished run and check the precision target
+static bool batch_result(long long index, const void* result, void* ctx) {
+    BatchContext* batch = (BatchContext*)ctx;
+    batch_summary_add(&batch->summary, *(const HeadlessResult*)result);
+    
+    if (batch->options.target_precision <= 0 || batch->summary.runs < BATCH_MIN_RUNS) {
+        return true;
+    }
+    
+    double low, high;
+    proportion_ci95(batch->summary.outcome_counts[OUTCOME_POLICE_WIN], batch->summary.runs, &low, &high);
+    if ((high - low) / 2 <= batch->options.target_precision) {
+        batch->summary.stopped_early = true;
+        return false;
+    }
+    return true;
+}
+
+// Run up to options.max_runs independent seeded simulations across worker
+// processes and aggregate their outcomes as they stream in
+BatchSummary run_batch(SimulationConfig config, BatchOptions options) {
+    BatchContext batch;
+    batch.config = config;
+    batch.options = options;
+    batch_summary_init(&batch.summary);
+    
+    int workers = options.num_workers > 0 ? options.num_workers : default_worker_count();
+    run_worker_pool(workers, options.max_runs, sizeof(HeadlessResult), batch_task, batch_result, &batch);
+    
+    return batch.summary;
+}
+
+// Print one running statistic as mean +/- CI with its range
+static void print_stat(const char* name, const RunningStat* stat) {
+    printf("  %-22s %10.2f +/- %-8.2f (sd %.2f, min %.0f, max %.0f)\n", name, stat->mean,
+           running_stat_ci95(stat), running_stat_stddev(stat), stat->min, stat->max);
+}
+
+// Print an aggregated batch summary
+void print_batch_summary(BatchSummary summary) {
+    printf("=== Batch Summary (%lld runs%s) ===\n", summary.runs,
+           summary.stopped_early ? ", stopped at target precision" : "");
+    
+    printf("Outcomes (95%% Wilson interval):\n");
+    for (int i = 0; i < NUM_OUTCOMES; i++) {
+        double low, high;
+        proportion_ci95(summary.outcome_counts[i], summary.runs, &low, &high);
+        printf("  %-22s %10lld  P = %.4f [%.4f, %.4f]\n", outcome_to_string((SimulationOutcome)i),
+               summary.outcome_counts[i],
+               summary.runs > 0 ? (double)summary.outcome_counts[i] / summary.runs : 0.0, low, high);
+    }
+    
+    printf("Per-run statistics (mean +/- 95%% CI):\n");
+    print_stat("Time to termination", &summary.time_units);
+    print_stat("Successful missions", &summary.successful_missions);
+    print_stat("Thwarted missions", &summary.thwarted_missions);
+    print_stat("Executed agents", &summary.executed_agents);
+    print_stat("Agents remaining", &summary.agents_remaining);
+    printf("  %-22s %10.4f +/- %-8.4f\n", "Agent survival rate", summary.agent_survival.mean,
+           running_stat_ci95(&summary.agent_survival));
+    printf("==================================\n");
+}
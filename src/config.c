@@ -1,8 +1,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <ctype.h>
+#include <stdbool.h>
 #include "../include/config.h"
+#include "../include/sim_clock.h"
+#include "../include/utils.h"
 
 // Function to trim whitespace from a string
 static char* trim(char* str) {
@@ -24,6 +28,144 @@ static char* trim(char* str) {
     return str;
 }
 
+// Split a config file line into trimmed key and value. Returns false for
+// comments, empty lines and lines without '='.
+static bool split_config_line(char* line, char** key, char** value) {
+    // Skip comments and empty lines
+    if (line[0] == '#' || line[0] == '\n') {
+        return false;
+    }
+    
+    // Remove newline character
+    line[strcspn(line, "\n")] = 0;
+    
+    // Split line into key and value
+    char* sep = strchr(line, '=');
+    if (sep == NULL) {
+        return false;
+    }
+    
+    *sep = 0;
+    *key = trim(line);
+    *value = trim(sep + 1);
+    return true;
+}
+
+// Set the configuration field named by key (a config file key such as
+// MIN_GANGS) from its string value. Returns false for unknown keys.
+bool set_config_value(SimulationConfig* config, const char* key, const char* value) {
+    if (strcmp(key, "MIN_GANGS") == 0) {
+        config->min_gangs = atoi(value);
+    }
+    else if (strcmp(key, "MAX_GANGS") == 0) {
+        config->max_gangs = atoi(value);
+    }
+    else if (strcmp(key, "MIN_MEMBERS_PER_GANG") == 0) {
+        config->min_members_per_gang = atoi(value);
+    }
+    else if (strcmp(key, "MAX_MEMBERS_PER_GANG") == 0) {
+        config->max_members_per_gang = atoi(value);
+    }
+    else if (strcmp(key, "GANG_RANKS") == 0) {
+        config->gang_ranks = atoi(value);
+    }
+    else if (strcmp(key, "PREPARATION_TIME_MIN") == 0) {
+        config->preparation_time_min = atoi(value);
+    }
+    else if (strcmp(key, "PREPARATION_TIME_MAX") == 0) {
+        config->preparation_time_max = atoi(value);
+    }
+    else if (strcmp(key, "MIN_PREPARATION_LEVEL") == 0) {
+        config->min_preparation_level = atoi(value);
+    }
+    else if (strcmp(key, "MAX_PREPARATION_LEVEL") == 0) {
+        config->max_preparation_level = atoi(value);
+    }
+    else if (strcmp(key, "FALSE_INFO_PROBABILITY") == 0) {
+        config->false_info_probability = atoi(value);
+    }
+    else if (strcmp(key, "AGENT_INFILTRATION_SUCCESS_RATE") == 0) {
+        config->agent_infiltration_success_rate = atoi(value);
+    }
+    else if (strcmp(key, "AGENT_SUSPICION_THRESHOLD") == 0) {
+        config->agent_suspicion_threshold = atoi(value);
+    }
+    else if (strcmp(key, "POLICE_ACTION_THRESHOLD") == 0) {
+        config->police_action_threshold = atoi(value);
+    }
+    else if (strcmp(key, "TRUTH_GAIN") == 0) {
+        config->truth_gain = atoi(value);
+    }
+    else if (strcmp(key, "FALSE_PENALTY") == 0) {
+        config->false_penalty = atoi(value);
+    }
+    else if (strcmp(key, "EXCHANGE_MODEL") == 0) {
+        // Values may carry a trailing comment, so match the leading word
+        if (strncasecmp(value, "HISTOGRAM", 9) == 0 || atoi(value) == 1) {
+            config->exchange_model = EXCHANGE_HISTOGRAM;
+        } else {
+            config->exchange_model = EXCHANGE_PAIRWISE;
+        }
+    }
+    else if (strcmp(key, "EVIDENCE_HALF_LIFE") == 0) {
+        config->evidence_half_life = atof(value);
+    }
+    else if (strcmp(key, "MISSION_SUCCESS_RATE_BASE") == 0) {
+        config->mission_success_rate_base = atoi(value);
+    }
+    else if (strcmp(key, "MEMBER_DEATH_PROBABILITY") == 0) {
+        config->member_death_probability = atoi(value);
+    }
+    else if (strcmp(key, "PRISON_TIME_MIN") == 0) {
+        config->prison_time_min = atoi(value);
+    }
+    else if (strcmp(key, "PRISON_TIME_MAX") == 0) {
+        config->prison_time_max = atoi(value);
+    }
+    else if (strcmp(key, "MAX_THWARTED_PLANS") == 0) {
+        config->max_thwarted_plans = atoi(value);
+    }
+    else if (strcmp(key, "MAX_SUCCESSFUL_PLANS") == 0) {
+        config->max_successful_plans = atoi(value);
+    }
+    else if (strcmp(key, "MAX_EXECUTED_AGENTS") == 0) {
+        config->max_executed_agents = atoi(value);
+    }
+    else if (strcmp(key, "SEED") == 0) {
+        config->seed = strtoull(value, NULL, 10);
+    }
+    else if (strcmp(key, "TIME_SCALE") == 0) {
+        config->time_scale = atof(value);
+    }
+    else if (strcmp(key, "VISUALIZATION_REFRESH_RATE") == 0) {
+        config->visualization_refresh_rate = atoi(value);
+    }
+    else if (strcmp(key, "SHM_BACKEND") == 0) {
+        if (strncasecmp(value, "POSIX", 5) == 0 || atoi(value) == 1) {
+            config->shm_backend = SHM_BACKEND_POSIX;
+        } else {
+            config->shm_backend = SHM_BACKEND_SYSV;
+        }
+    }
+    else if (strcmp(key, "SHM_PREFAULT") == 0) {
+        config->shm_prefault = atoi(value) != 0;
+    }
+    else if (strcmp(key, "SHM_HUGE_PAGES") == 0) {
+        if (strncasecmp(value, "EXPLICIT", 8) == 0 || atoi(value) == 2) {
+            config->shm_huge_pages = SHM_HUGE_PAGES_EXPLICIT;
+        } else if (strncasecmp(value, "TRANSPARENT", 11) == 0 || atoi(value) == 1) {
+            config->shm_huge_pages = SHM_HUGE_PAGES_TRANSPARENT;
+        } else {
+            config->shm_huge_pages = SHM_HUGE_PAGES_NONE;
+        }
+    }
+    else {
+        return false;
+    }
+    
+    return true;
+}
+
 // Load configuration from file
 SimulationConfig load_config(const char* config_file) {
     SimulationConfig config;
@@ -50,6 +192,8 @@ SimulationConfig load_config(const char* config_file) {
     config.police_action_threshold = 80;
     config.truth_gain = 10;        // Default knowledge gain
     config.false_penalty = 5;      // Default knowledge penalty
+    config.exchange_model = EXCHANGE_PAIRWISE;
+    config.evidence_half_life = 5.0;
     config.mission_success_rate_base = 50;
     config.member_death_probability = 10;
     config.prison_time_min = 5;
@@ -57,103 +201,201 @@ SimulationConfig load_config(const char* config_file) {
     config.max_thwarted_plans = 10;
     config.max_successful_plans = 15;
     config.max_executed_agents = 5;
+    config.seed = 0;
+    config.time_scale = 1.0;
     config.visualization_refresh_rate = 1000;
+    config.shm_backend = SHM_BACKEND_SYSV;
+    config.shm_prefault = false;
+    config.shm_huge_pages = SHM_HUGE_PAGES_NONE;
     
     // Parse configuration file
     char line[256];
+    char* key;
+    char* value;
     while (fgets(line, sizeof(line), file)) {
-        // Skip comments and empty lines
-        if (line[0] == '#' || line[0] == '\n') {
+        if (!split_config_line(line, &key, &value)) {
             continue;
         }
         
-        // Remove newline character
-        line[strcspn(line, "\n")] = 0;
-        
-        // Split line into key and value
-        char* sep = strchr(line, '=');
-        if (sep == NULL) {
+        // Parse configuration parameters (unknown keys are ignored)
+        set_config_value(&config, key, value);
+    }
+    
+    fclose(file);
+    return config;
+}
+
+// Parse a sweep range "min..max" or "min..max:step". Returns false if the
+// value is a plain scalar.
+static bool parse_sweep_range(const char* value, SweepAxis* axis) {
+    const char* dots = strstr(value, "..");
+    if (dots == NULL) {
+        return false;
+    }
+    
+    // Parse min from its own copy; strtod would read "10." out of "10..90"
+    char min_text[32];
+    size_t min_length = dots - value;
+    if (min_length == 0 || min_length >= sizeof(min_text)) {
+        return false;
+    }
+    memcpy(min_text, value, min_length);
+    min_text[min_length] = '\0';
+    
+    char* end;
+    axis->min = strtod(min_text, &end);
+    if (*end != '\0') {
+        return false;
+    }
+    axis->max = strtod(dots + 2, &end);
+    
+    axis->step = 0.0;
+    if (*end == ':') {
+        axis->step = strtod(end + 1, &end);
+    }
+    
+    // Allow trailing comments after the range
+    while (isspace((unsigned char)*end)) end++;
+    return *end == '\0' || *end == '#';
+}
+
+// Load the sweep definition from a config file. Any key whose value is a
+// range becomes a sweep axis:
+//   KEY=min..max:step   grid axis over min, min+step, ..., max
+//   KEY=min..max        continuous axis, sampled when SWEEP_SAMPLES > 0
+// SWEEP_SAMPLES=N switches from the full grid to N random points and
+// SWEEP_RUNS=R sets the number of simulations per point.
+bool load_sweep(const char* config_file, SweepSpec* spec) {
+    FILE* file = fopen(config_file, "r");
+    if (file == NULL) {
+        fprintf(stderr, "Error: Unable to open config file %s\n", config_file);
+        return false;
+    }
+    
+    memset(spec, 0, sizeof(*spec));
+    spec->runs_per_point = 1;
+    
+    SimulationConfig probe;
+    char line[256];
+    char* key;
+    char* value;
+    while (fgets(line, sizeof(line), file)) {
+        if (!split_config_line(line, &key, &value)) {
             continue;
         }
         
-        *sep = 0;
-        char* key = trim(line);
-        char* value = trim(sep + 1);
-        
-        // Parse configuration parameters
-        if (strcmp(key, "MIN_GANGS") == 0) {
-            config.min_gangs = atoi(value);
-        }
-        else if (strcmp(key, "MAX_GANGS") == 0) {
-            config.max_gangs = atoi(value);
-        }
-        else if (strcmp(key, "MIN_MEMBERS_PER_GANG") == 0) {
-            config.min_members_per_gang = atoi(value);
-        }
-        else if (strcmp(key, "MAX_MEMBERS_PER_GANG") == 0) {
-            config.max_members_per_gang = atoi(value);
-        }
-        else if (strcmp(key, "GANG_RANKS") == 0) {
-            config.gang_ranks = atoi(value);
-        }
-        else if (strcmp(key, "PREPARATION_TIME_MIN") == 0) {
-            config.preparation_time_min = atoi(value);
-        }
-        else if (strcmp(key, "PREPARATION_TIME_MAX") == 0) {
-            config.preparation_time_max = atoi(value);
-        }
-        else if (strcmp(key, "MIN_PREPARATION_LEVEL") == 0) {
-            config.min_preparation_level = atoi(value);
-        }
-        else if (strcmp(key, "MAX_PREPARATION_LEVEL") == 0) {
-            config.max_preparation_level = atoi(value);
-        }
-        else if (strcmp(key, "FALSE_INFO_PROBABILITY") == 0) {
-            config.false_info_probability = atoi(value);
-        }
-        else if (strcmp(key, "AGENT_INFILTRATION_SUCCESS_RATE") == 0) {
-            config.agent_infiltration_success_rate = atoi(value);
-        }
-        else if (strcmp(key, "AGENT_SUSPICION_THRESHOLD") == 0) {
-            config.agent_suspicion_threshold = atoi(value);
-        }
-        else if (strcmp(key, "POLICE_ACTION_THRESHOLD") == 0) {
-            config.police_action_threshold = atoi(value);
-        }
-        else if (strcmp(key, "TRUTH_GAIN") == 0) {
-            config.truth_gain = atoi(value);
-        }
-        else if (strcmp(key, "FALSE_PENALTY") == 0) {
-            config.false_penalty = atoi(value);
-        }
-        else if (strcmp(key, "MISSION_SUCCESS_RATE_BASE") == 0) {
-            config.mission_success_rate_base = atoi(value);
+        if (strcmp(key, "SWEEP_SAMPLES") == 0) {
+            spec->num_samples = atoll(value);
+            continue;
         }
-        else if (strcmp(key, "MEMBER_DEATH_PROBABILITY") == 0) {
-            config.member_death_probability = atoi(value);
+        if (strcmp(key, "SWEEP_RUNS") == 0) {
+            spec->runs_per_point = atoi(value);
+            continue;
         }
-        else if (strcmp(key, "PRISON_TIME_MIN") == 0) {
-            config.prison_time_min = atoi(value);
+        
+        SweepAxis axis;
+        if (!parse_sweep_range(value, &axis)) {
+            continue;
         }
-        else if (strcmp(key, "PRISON_TIME_MAX") == 0) {
-            config.prison_time_max = atoi(value);
+        
+        if (!set_config_value(&probe, key, "0")) {
+            fprintf(stderr, "Error: Unknown sweep key %s\n", key);
+            fclose(file);
+            return false;
         }
-        else if (strcmp(key, "MAX_THWARTED_PLANS") == 0) {
-            config.max_thwarted_plans = atoi(value);
+        if (spec->num_axes == SWEEP_MAX_AXES) {
+            fprintf(stderr, "Error: At most %d sweep axes are supported\n", SWEEP_MAX_AXES);
+            fclose(file);
+            return false;
         }
-        else if (strcmp(key, "MAX_SUCCESSFUL_PLANS") == 0) {
-            config.max_successful_plans = atoi(value);
+        if (axis.max < axis.min || axis.step < 0) {
+            fprintf(stderr, "Error: Invalid sweep range for %s\n", key);
+            fclose(file);
+            return false;
         }
-        else if (strcmp(key, "MAX_EXECUTED_AGENTS") == 0) {
-            config.max_executed_agents = atoi(value);
+        
+        snprintf(axis.key, sizeof(axis.key), "%s", key);
+        spec->axes[spec->num_axes++] = axis;
+    }
+    fclose(file);
+    
+    if (spec->runs_per_point < 1) {
+        spec->runs_per_point = 1;
+    }
+    
+    // A full grid needs a step on every axis
+    if (spec->num_samples <= 0) {
+        for (int i = 0; i < spec->num_axes; i++) {
+            if (spec->axes[i].step <= 0) {
+                fprintf(stderr, "Error: Sweep axis %s needs a step (KEY=min..max:step) "
+                        "unless SWEEP_SAMPLES is set\n", spec->axes[i].key);
+                return false;
+            }
         }
-        else if (strcmp(key, "VISUALIZATION_REFRESH_RATE") == 0) {
-            config.visualization_refresh_rate = atoi(value);
+    }
+    
+    return true;
+}
+
+// Number of grid values on an axis
+static long long sweep_axis_points(const SweepAxis* axis) {
+    if (axis->step <= 0) {
+        return 1;
+    }
+    return (long long)((axis->max - axis->min) / axis->step + 1e-9) + 1;
+}
+
+// Total number of sweep points
+long long sweep_num_points(const SweepSpec* spec) {
+    if (spec->num_samples > 0) {
+        return spec->num_samples;
+    }
+    
+    long long points = 1;
+    for (int i = 0; i < spec->num_axes; i++) {
+        points *= sweep_axis_points(&spec->axes[i]);
+    }
+    return points;
+}
+
+// Axis values of sweep point index. Grid points are enumerated in row-major
+// order; random points come from the stream keyed by (seed, index, axis), so
+// any point can be regenerated on its own. Continuous axes with integer bounds sample
+// integers, since most configuration fields are integers.
+void sweep_point_values(const SweepSpec* spec, long long index, uint64_t seed, double* values) {
+    if (spec->num_samples > 0) {
+        for (int i = 0; i < spec->num_axes; i++) {
+            const SweepAxis* axis = &spec->axes[i];
+            RngStream stream;
+            rng_stream_init(&stream, seed, (int)index, i);
+            double u = (rng_next(&stream) >> 11) * (1.0 / 9007199254740992.0);  // Uniform in [0, 1)
+            
+            if (axis->step > 0) {
+                values[i] = axis->min + axis->step * (long long)(u * sweep_axis_points(axis));
+            } else if (axis->min == (long long)axis->min && axis->max == (long long)axis->max) {
+                values[i] = axis->min + (long long)(u * (axis->max - axis->min + 1));
+            } else {
+                values[i] = axis->min + u * (axis->max - axis->min);
+            }
         }
+        return;
     }
     
-    fclose(file);
-    return config;
+    for (int i = spec->num_axes - 1; i >= 0; i--) {
+        long long points = sweep_axis_points(&spec->axes[i]);
+        values[i] = spec->axes[i].min + spec->axes[i].step * (index % points);
+        index /= points;
+    }
+}
+
+// Apply axis values on top of a base configuration
+SimulationConfig sweep_point_config(SimulationConfig base, const SweepSpec* spec, const double* values) {
+    char value[64];
+    for (int i = 0; i < spec->num_axes; i++) {
+        snprintf(value, sizeof(value), "%.17g", values[i]);
+        set_config_value(&base, spec->axes[i].key, value);
+    }
+    return base;
 }
 
 // Print configuration values
@@ -175,6 +417,8 @@ void print_config(SimulationConfig config) {
     printf("  - Police action threshold: %d%%\n", config.police_action_threshold);
     printf("  - Truth gain: %d\n", config.truth_gain);
     printf("  - False penalty: %d\n", config.false_penalty);
+    printf("  - Exchange model: %s\n", config.exchange_model == EXCHANGE_HISTOGRAM ? "histogram" : "pairwise");
+    printf("  - Evidence half-life: %.1f time units\n", config.evidence_half_life);
     
     printf("\nMission Outcomes:\n");
     printf("  - Base mission success rate: %d%%\n", config.mission_success_rate_base);
@@ -186,7 +430,26 @@ void print_config(SimulationConfig config) {
     printf("  - Max successful plans: %d\n", config.max_successful_plans);
     printf("  - Max executed agents: %d\n", config.max_executed_agents);
     
+    printf("\nRandom Numbers:\n");
+    if (config.seed != 0) {
+        printf("  - Seed: %llu\n", config.seed);
+    } else {
+        printf("  - Seed: chosen at startup\n");
+    }
+    
+    printf("\nSimulation Clock:\n");
+    printf("  - Time scale: %.2fx (1 time unit = %.0f ms)\n", config.time_scale,
+           config.time_scale > 0 ? SIM_TIME_UNIT_MS / config.time_scale : 0.0);
+    
     printf("\nVisualization:\n");
     printf("  - Refresh rate: %d ms\n", config.visualization_refresh_rate);
+    
+    static const char* huge_page_names[] = {"none", "transparent", "explicit"};
+    printf("\nShared Memory:\n");
+    printf("  - Backend: %s\n", config.shm_backend == SHM_BACKEND_POSIX ? "POSIX" : "System V");
+    if (config.shm_backend == SHM_BACKEND_POSIX) {
+        printf("  - Pre-fault: %s\n", config.shm_prefault ? "yes" : "no");
+        printf("  - Huge pages: %s\n", huge_page_names[config.shm_huge_pages]);
+    }
     printf("==============================\n\n");
 }
@@ -4,48 +4,230 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <stdatomic.h>
+#include <limits.h>
 #include "../include/gang.h"
 #include "../include/utils.h"
 #include "../include/ipc.h"
+#include "../include/sim_clock.h"
+#include "../include/task_pool.h"
+#include "../include/worker_pool.h"
 
 // Original deliver_truth function removed - using the new version with false_info_probability parameter
 
-// Initialize a gang
-void initialize_gang(Gang* gang, int id, int num_members, int num_ranks, SimulationConfig config) {
+// Allocate one array per member attribute
+static void allocate_member_store(MemberStore* m, int num_members) {
+    m->seq = (atomic_uint*)malloc(num_members * sizeof(atomic_uint));
+    m->rank = (int*)malloc(num_members * sizeof(int));
+    m->preparation_level = (atomic_int*)malloc(num_members * sizeof(atomic_int));
+    m->knowledge = (atomic_int*)malloc(num_members * sizeof(atomic_int));
+    m->suspicion = (int*)malloc(num_members * sizeof(int));
+    m->knowledge_rate = (atomic_int*)malloc(num_members * sizeof(atomic_int));
+    m->is_secret_agent = (bool*)malloc(num_members * sizeof(bool));
+    m->alive = (bool*)malloc(num_members * sizeof(bool));
+    m->in_prison = (bool*)malloc(num_members * sizeof(bool));
+    
+    if (m->seq == NULL || m->rank == NULL || m->preparation_level == NULL || m->knowledge == NULL ||
+        m->suspicion == NULL || m->knowledge_rate == NULL || m->is_secret_agent == NULL ||
+        m->alive == NULL || m->in_prison == NULL) {
+        perror("Failed to allocate member store");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Release the member attribute arrays
+static void free_member_store(MemberStore* m) {
+    free(m->seq);
+    free(m->rank);
+    free(m->preparation_level);
+    free(m->knowledge);
+    free(m->suspicion);
+    free(m->knowledge_rate);
+    free(m->is_secret_agent);
+    free(m->alive);
+    free(m->in_prison);
+}
+
+// Suspicion score of a member from the current mission's inputs:
+// 1. Low preparation level may indicate lack of commitment
+// 2. Newer members (lower ranks) are more suspicious
+// 3. Low-rank members shouldn't know too much
+static inline int suspicion_score(const Gang* gang, int preparation_level, int knowledge_rate, int rank) {
+    return 20 * (preparation_level < gang->required_preparation_level / 2)
+         + (gang->num_ranks - rank) * 5
+         + 25 * ((knowledge_rate > 80) & (rank < 2));
+}
+
+// Whether member a comes before member b in the suspect heap
+static inline bool suspect_before(const Gang* gang, int a, int b) {
+    const int* suspicion = gang->member_data.suspicion;
+    return suspicion[a] > suspicion[b] || (suspicion[a] == suspicion[b] && a < b);
+}
+
+// Swap two heap slots and keep the position index in step
+static inline void suspect_swap(SuspectHeap* heap, int i, int j) {
+    int member_i = heap->members[i];
+    int member_j = heap->members[j];
+    heap->members[i] = member_j;
+    heap->members[j] = member_i;
+    heap->position[member_j] = i;
+    heap->position[member_i] = j;
+}
+
+// Restore heap order around slot i after its member's score changed
+static void suspect_sift(Gang* gang, int i) {
+    SuspectHeap* heap = &gang->suspects;
+    while (i > 0 && suspect_before(gang, heap->members[i], heap->members[(i - 1) / 2])) {
+        suspect_swap(heap, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+    while (true) {
+        int best = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+        if (left < gang->num_members && suspect_before(gang, heap->members[left], heap->members[best])) {
+            best = left;
+        }
+        if (right < gang->num_members && suspect_before(gang, heap->members[right], heap->members[best])) {
+            best = right;
+        }
+        if (best == i) {
+            return;
+        }
+        suspect_swap(heap, i, best);
+        i = best;
+    }
+}
+
+// Allocate the suspect heap with every member in it
+static void allocate_suspect_heap(SuspectHeap* heap, int num_members) {
+    pthread_mutex_init(&heap->lock, NULL);
+    heap->members = (int*)malloc(num_members * sizeof(int));
+    heap->position = (int*)malloc(num_members * sizeof(int));
+    if (heap->members == NULL || heap->position == NULL) {
+        perror("Failed to allocate suspect heap");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_members; i++) {
+        heap->members[i] = i;
+        heap->position[i] = i;
+    }
+    heap->num_suspects = 0;
+}
+
+// Release the suspect heap
+static void free_suspect_heap(SuspectHeap* heap) {
+    pthread_mutex_destroy(&heap->lock);
+    free(heap->members);
+    free(heap->position);
+}
+
+// Store a member's new suspicion score and move it in the suspect heap
+static void set_suspicion(Gang* gang, int member_id, int score) {
+    SuspectHeap* heap = &gang->suspects;
+    int* suspicion = gang->member_data.suspicion;
+    
+    pthread_mutex_lock(&heap->lock);
+    heap->num_suspects += (score > SUSPECT_SCORE_THRESHOLD) - (suspicion[member_id] > SUSPECT_SCORE_THRESHOLD);
+    suspicion[member_id] = score;
+    suspect_sift(gang, heap->position[member_id]);
+    pthread_mutex_unlock(&heap->lock);
+}
+
+// Recompute a member's score from its current state, touching the heap
+// only if the score changed. Called by the member's own tick or inside a
+// mission transition.
+static void refresh_suspicion(Gang* gang, int member_id) {
+    MemberStore* m = &gang->member_data;
+    int score = suspicion_score(gang,
+                                atomic_load_explicit(&m->preparation_level[member_id], memory_order_relaxed),
+                                atomic_load_explicit(&m->knowledge_rate[member_id], memory_order_relaxed),
+                                m->rank[member_id]);
+    if (score != m->suspicion[member_id]) {
+        set_suspicion(gang, member_id, score);
+    }
+}
+
+// Recompute every score and rebuild the heap, for a new mission. Must be
+// called inside a mission transition.
+static void rebuild_suspects(Gang* gang) {
+    SuspectHeap* heap = &gang->suspects;
+    MemberStore* m = &gang->member_data;
+    
+    pthread_mutex_lock(&heap->lock);
+    heap->num_suspects = 0;
+    for (int i = 0; i < gang->num_members; i++) {
+        m->suspicion[i] = suspicion_score(gang,
+                                          atomic_load_explicit(&m->preparation_level[i], memory_order_relaxed),
+                                          atomic_load_explicit(&m->knowledge_rate[i], memory_order_relaxed),
+                                          m->rank[i]);
+        heap->num_suspects += m->suspicion[i] > SUSPECT_SCORE_THRESHOLD;
+    }
+    for (int i = gang->num_members / 2 - 1; i >= 0; i--) {
+        suspect_sift(gang, i);
+    }
+    pthread_mutex_unlock(&heap->lock);
+}
+
+// Initialize a gang's state and members without starting its task pool
+void initialize_gang_state(Gang* gang, int id, int num_members, int num_ranks, SimulationConfig config) {
     gang->id = id;
     gang->num_members = num_members;
     gang->num_ranks = num_ranks;
-    gang->is_active = true;
-    gang->is_in_prison = false;
+    atomic_init(&gang->is_active, true);
+    atomic_init(&gang->is_in_prison, false);
+    atomic_init(&gang->mission_version, 0);
+    atomic_init(&gang->active_ticks, 0);
+    atomic_init(&gang->total_preparation, 0);
     gang->prison_time_remaining = 0;
     gang->successful_missions = 0;
     gang->thwarted_missions = 0;
     gang->executed_agents = 0;
+    gang->num_agents = 0;
     gang->false_info_probability = config.false_info_probability;
     gang->truth_gain = config.truth_gain;
     gang->false_penalty = config.false_penalty;
-    gang->report_queue_id = -1; // Will be set by the main process
+    gang->report_queue_id = -1; // Set by initialize_gang for the real-time path
+    gang->pool = NULL;
+    gang->publish_preparation = false;
+    gang->truth_table = NULL;
+    gang->truth_table_ranks = 0;
+    gang->truth_table_false_info = 0;
+    refresh_truth_table(gang);
+    gang->exchange_model = config.exchange_model;
     
-    // Initialize mutex and condition variable
+    // Initialize mutex
     pthread_mutex_init(&gang->gang_mutex, NULL);
-    pthread_cond_init(&gang->gang_cond, NULL);
     
     // Allocate members
-    gang->members = (GangMember*)malloc(num_members * sizeof(GangMember));
+    allocate_member_store(&gang->member_data, num_members);
+    gang->member_streams = (RngStream*)malloc(num_members * sizeof(RngStream));
+    gang->active_by_rank = (int*)calloc(num_ranks, sizeof(int));
+    allocate_suspect_heap(&gang->suspects, num_members);
+    if (gang->member_streams == NULL || gang->active_by_rank == NULL) {
+        perror("Failed to allocate gang members");
+        exit(EXIT_FAILURE);
+    }
     
     // Initialize gang members
+    MemberStore* m = &gang->member_data;
     for (int i = 0; i < num_members; i++) {
-        gang->members[i].id = i;
-        gang->members[i].rank = i % num_ranks;  // Distribute ranks evenly at first
-        gang->members[i].preparation_level = 0;
-        gang->members[i].knowledge_rate = 0;
-        gang->members[i].suspicion = 0;
-        gang->members[i].alive = true;
-        gang->members[i].in_prison = false;
-        gang->members[i].gang_ptr = gang;
+        rng_stream_init(&gang->member_streams[i], rng_get_seed(), id, i);
+        
+        atomic_init(&m->seq[i], 0);
+        m->rank[i] = i % num_ranks;  // Distribute ranks evenly at first
+        atomic_init(&m->preparation_level[i], 0);
+        atomic_init(&m->knowledge[i], 0);
+        atomic_init(&m->knowledge_rate[i], 0);
+        m->suspicion[i] = 0;
+        m->alive[i] = true;
+        m->in_prison[i] = false;
         
         // Determine if this member is a secret agent
-        gang->members[i].is_secret_agent = random_event(config.agent_infiltration_success_rate);
+        m->is_secret_agent[i] = random_event(config.agent_infiltration_success_rate);
+        gang->num_agents += m->is_secret_agent[i];
+        
+        gang->active_by_rank[m->rank[i]]++;
     }
     
     // Store process ID
@@ -53,157 +235,353 @@ void initialize_gang(Gang* gang, int id, int num_members, int num_ranks, Simulat
     
     // Plan initial mission
     plan_new_mission(gang, config);
+}
+
+static void gang_member_task(const SimEvent* event, void* ctx);
+
+// Initialize a gang that sends reports to report_queue_id and publishes its
+// progress, and start running its members' ticks on a task pool. The
+// num_gangs gang processes share the cores, so each gets an equal share of
+// them as workers (at least one).
+void initialize_gang(Gang* gang, int id, int num_members, int num_ranks, int num_gangs,
+                     int report_queue_id, SimulationConfig config) {
+    initialize_gang_state(gang, id, num_members, num_ranks, config);
+    
+    // Set before the workers start, since member ticks read them
+    gang->report_queue_id = report_queue_id;
+    gang->publish_preparation = true;
+    
+    int num_workers = default_worker_count() / (num_gangs > 0 ? num_gangs : 1);
+    if (num_workers < 1) {
+        num_workers = 1;
+    }
+    if (num_workers > num_members) {
+        num_workers = num_members;
+    }
+    
+    gang->pool = (TaskPool*)malloc(sizeof(TaskPool));
+    if (gang->pool == NULL) {
+        perror("Failed to allocate gang task pool");
+        exit(EXIT_FAILURE);
+    }
+    task_pool_init(gang->pool, num_workers, gang_member_task, gang);
     
-    // Create threads for gang members
     for (int i = 0; i < num_members; i++) {
-        pthread_create(&gang->members[i].thread, NULL, gang_member_routine, &gang->members[i]);
+        task_pool_submit(gang->pool, EVENT_MEMBER_TICK, id, i);
     }
     
-    log_message("Gang %d initialized with %d members and %d ranks", id, num_members, num_ranks);
+    log_message("Gang %d initialized with %d members, %d ranks and %d workers",
+               id, num_members, num_ranks, num_workers);
 }
 
-// Gang member thread routine
-void* gang_member_routine(void* arg) {
-    GangMember* member = (GangMember*)arg;
-    Gang* gang = (Gang*)member->gang_ptr;
+// Clamp knowledge and knowledge_rate to 0..100
+static inline int clamp_knowledge(int value) {
+    if (value < 0) {
+        return 0;
+    } else if (value > 100) {
+        return 100;
+    }
+    return value;
+}
+
+// Per-thread scratch space for exchange_pairwise, grown to the largest gang
+// seen. Ticks of one gang run concurrently, so it cannot live in the Gang.
+static _Thread_local uint32_t* exchange_thresholds = NULL;
+static _Thread_local uint8_t* exchange_outcomes = NULL;
+static _Thread_local int exchange_capacity = 0;
+
+// Make sure this thread's exchange scratch holds num_members entries
+static void reserve_exchange_scratch(int num_members) {
+    if (num_members <= exchange_capacity) {
+        return;
+    }
+    free(exchange_thresholds);
+    free(exchange_outcomes);
+    exchange_thresholds = (uint32_t*)malloc(num_members * sizeof(uint32_t));
+    exchange_outcomes = (uint8_t*)malloc(num_members * sizeof(uint8_t));
+    if (exchange_thresholds == NULL || exchange_outcomes == NULL) {
+        perror("Failed to allocate exchange scratch");
+        exit(EXIT_FAILURE);
+    }
+    exchange_capacity = num_members;
+}
+
+// Pairwise knowledge exchange: one truth/false outcome per other active
+// member. Outcomes for every member are drawn in one block from the gang's
+// rank table; the apply loop ignores self and inactive members.
+static void exchange_pairwise(Gang* gang, int member_id, int gain, int penalty) {
+    MemberStore* m = &gang->member_data;
+    int num_members = gang->num_members;
+    reserve_exchange_scratch(num_members);
+    uint32_t* thresholds = exchange_thresholds;
+    uint8_t* outcomes = exchange_outcomes;
+    const uint32_t* truth_column = gang->truth_table + m->rank[member_id];
     
-    while (gang->is_active) {
-        // Wait if gang is in prison
-        pthread_mutex_lock(&gang->gang_mutex);
-        while (gang->is_in_prison) {
-            pthread_cond_wait(&gang->gang_cond, &gang->gang_mutex);
+    for (int i = 0; i < num_members; i++) {
+        thresholds[i] = truth_column[m->rank[i] * gang->num_ranks];
+    }
+    
+    random_events_fill(thresholds, outcomes, num_members);
+    
+    int knowledge = atomic_load_explicit(&m->knowledge[member_id], memory_order_relaxed);
+    int knowledge_rate = atomic_load_explicit(&m->knowledge_rate[member_id], memory_order_relaxed);
+    
+    for (int i = 0; i < num_members; i++) {
+        // Only interact with other, active members; a zero delta leaves the
+        // clamped values unchanged
+        int partner = (i != member_id) & m->alive[i] & !m->in_prison[i];
+        int delta = partner * (outcomes[i] ? gain : -penalty);
+        
+        knowledge = clamp_knowledge(knowledge + delta);
+        knowledge_rate = clamp_knowledge(knowledge_rate + delta);
+    }
+    
+    atomic_store_explicit(&m->knowledge[member_id], knowledge, memory_order_relaxed);
+    // knowledge_rate is kept for backward compatibility and only tracked for agents
+    if (m->is_secret_agent[member_id]) {
+        atomic_store_explicit(&m->knowledge_rate[member_id], knowledge_rate, memory_order_relaxed);
+    }
+}
+
+// Rank-histogram knowledge exchange: the number of truthful messages from
+// each rank is one binomial draw over that rank's active members. Same
+// expected change as exchange_pairwise, clamped once per tick, O(ranks).
+static void exchange_by_rank(Gang* gang, int member_id, int gain, int penalty) {
+    MemberStore* m = &gang->member_data;
+    int receiver_rank = m->rank[member_id];
+    int truthful = 0;
+    int partners = 0;
+    
+    for (int rank = 0; rank < gang->num_ranks; rank++) {
+        int senders = gang->active_by_rank[rank];
+        if (rank == receiver_rank && member_is_active(gang, member_id)) {
+            senders--;  // Skip self
+        }
+        if (senders <= 0) {
+            continue;
         }
-        pthread_mutex_unlock(&gang->gang_mutex);
         
-        // Increase preparation level
+        uint32_t threshold = gang->truth_table[rank * gang->num_ranks + receiver_rank];
+        truthful += random_binomial(senders, threshold / 2147483648.0);
+        partners += senders;
+    }
+    
+    int delta = truthful * gain - (partners - truthful) * penalty;
+    int knowledge = atomic_load_explicit(&m->knowledge[member_id], memory_order_relaxed);
+    atomic_store_explicit(&m->knowledge[member_id], clamp_knowledge(knowledge + delta), memory_order_relaxed);
+    if (m->is_secret_agent[member_id]) {
+        int knowledge_rate = atomic_load_explicit(&m->knowledge_rate[member_id], memory_order_relaxed);
+        atomic_store_explicit(&m->knowledge_rate[member_id], clamp_knowledge(knowledge_rate + delta),
+                              memory_order_relaxed);
+    }
+}
+
+// Wait out a mission transition in progress, asleep until
+// end_mission_transition wakes us, and return the version it left
+static unsigned int stable_mission_version(Gang* gang) {
+    unsigned int version = atomic_load(&gang->mission_version);
+    while (version & 1) {
+        futex_wait(&gang->mission_version, version, NULL);
+        version = atomic_load(&gang->mission_version);
+    }
+    return version;
+}
+
+// Start a mission transition: take gang_mutex, make mission_version odd so
+// no new tick starts, then sleep until running ticks finish (the last one
+// out wakes us). Everything a tick reads may be changed until
+// end_mission_transition.
+void begin_mission_transition(Gang* gang) {
+    pthread_mutex_lock(&gang->gang_mutex);
+    atomic_fetch_add(&gang->mission_version, 1);
+    unsigned int active;
+    while ((active = atomic_load(&gang->active_ticks)) != 0) {
+        futex_wait(&gang->active_ticks, active, NULL);
+    }
+}
+
+// Publish the new mission state and let ticks run again
+void end_mission_transition(Gang* gang) {
+    atomic_fetch_add(&gang->mission_version, 1);
+    futex_wake(&gang->mission_version, INT_MAX);
+    pthread_mutex_unlock(&gang->gang_mutex);
+}
+
+// Unregister a tick started with enter_member_tick. The last tick to leave
+// while a transition waits wakes it; outside transitions no system call is
+// made.
+static void leave_member_tick(Gang* gang) {
+    if (atomic_fetch_sub(&gang->active_ticks, 1) == 1 &&
+        (atomic_load(&gang->mission_version) & 1)) {
+        futex_wake(&gang->active_ticks, 1);
+    }
+}
+
+// Register a running tick, waiting out any mission transition in progress.
+// The counter is raised before the version is checked and the transition
+// does the opposite, so one of the two always sees the other. A tick that
+// backs out leaves like a finished one, since the transition may be asleep
+// waiting for exactly that.
+static void enter_member_tick(Gang* gang) {
+    while (true) {
+        atomic_fetch_add(&gang->active_ticks, 1);
+        if ((atomic_load(&gang->mission_version) & 1) == 0) {
+            return;
+        }
+        leave_member_tick(gang);
+        stable_mission_version(gang);
+    }
+}
+
+// One preparation step for a member, including its knowledge exchange.
+// Takes no lock: ticks of different members run concurrently and only write
+// their own member's progress. Returns true and fills in report when the
+// member is a secret agent with enough knowledge to inform the police.
+bool gang_member_tick(Gang* gang, int member_id, IntelligenceReport* report) {
+    MemberStore* m = &gang->member_data;
+    bool has_report = false;
+    
+    enter_member_tick(gang);
+    
+    int required_level = gang->required_preparation_level;
+    int previous_level = atomic_load_explicit(&m->preparation_level[member_id], memory_order_relaxed);
+    int preparation_level = previous_level;
+    if (preparation_level >= required_level) {
+        leave_member_tick(gang);
+        return false;
+    }
+    
+    // Higher rank members prepare faster
+    int receiver_rank = m->rank[member_id];
+    int preparation_step = 5 + (receiver_rank * 2); // Increased step size to make progress visible
+    preparation_level += preparation_step;
+    
+    if (preparation_level > required_level) {
+        preparation_level = required_level;
+    }
+    
+    // Readers retry while seq is odd or changes under them
+    unsigned int seq = atomic_load_explicit(&m->seq[member_id], memory_order_relaxed);
+    atomic_store_explicit(&m->seq[member_id], seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&m->preparation_level[member_id], preparation_level, memory_order_relaxed);
+    atomic_fetch_add_explicit(&gang->total_preparation, preparation_level - previous_level, memory_order_relaxed);
+    
+    // Knowledge exchange happens for all members
+    // For regular members, this is just normal gang communication
+    // For secret agents, this represents intelligence gathering
+    
+    // Simulate information exchange with other members
+    // R-6: Knowledge Accumulation with configurable truth gain and false penalty
+    // for secret agents; regular members use the fixed +5/-3 of normal gang
+    // communication. R-5: agents are unaware of each other, so every partner is
+    // treated as a regular member.
+    bool is_agent = m->is_secret_agent[member_id];
+    int gain = is_agent ? gang->truth_gain : 5;
+    int penalty = is_agent ? gang->false_penalty : 3;
+    
+    if (gang->exchange_model == EXCHANGE_HISTOGRAM) {
+        exchange_by_rank(gang, member_id, gain, penalty);
+    } else {
+        exchange_pairwise(gang, member_id, gain, penalty);
+    }
+    atomic_store_explicit(&m->seq[member_id], seq + 2, memory_order_release);
+    
+    // If member is a secret agent, potentially report to police
+    // Report to police if suspicion is high enough
+    int knowledge_rate = atomic_load_explicit(&m->knowledge_rate[member_id], memory_order_relaxed);
+    if (is_agent && knowledge_rate >= required_level / 2) {
+        // Create intelligence report
+        report->gang_id = gang->id;
+        report->agent_id = member_id;
+        report->suspected_target = gang->current_target;
+        report->suspicion_level = knowledge_rate;
+        report->is_reliable = receiver_rank > (gang->num_ranks / 2);
+        report->time_ms = sim_clock_now_ms();
+        has_report = true;
+    }
+    
+    refresh_suspicion(gang, member_id);
+    leave_member_tick(gang);
+    return has_report;
+}
+
+// Task pool handler: one member tick, then schedule the member's next tick.
+// While the gang is in prison the tick is parked instead, until
+// gang_process_step releases the gang.
+static void gang_member_task(const SimEvent* event, void* ctx) {
+    Gang* gang = (Gang*)ctx;
+    int member_id = event->member_id;
+    
+    if (!gang->is_active) {
+        return;
+    }
+    if (gang->is_in_prison) {
+        // Park under gang_mutex, which the release also holds, so the
+        // release cannot be missed; re-check in case it just happened
         pthread_mutex_lock(&gang->gang_mutex);
-        if (member->preparation_level < gang->required_preparation_level) {
-            // Higher rank members prepare faster
-            int preparation_step = 5 + (member->rank * 2); // Increased step size to make progress visible
-            member->preparation_level += preparation_step;
-            
-            if (member->preparation_level > gang->required_preparation_level) {
-                member->preparation_level = gang->required_preparation_level;
-            }
-            
-            // Knowledge exchange happens for all members
-            // For regular members, this is just normal gang communication
-            // For secret agents, this represents intelligence gathering
-            
-            // Simulate information exchange with other members
-            // For each interaction, determine if truth or disinformation is shared
-            for (int i = 0; i < gang->num_members; i++) {
-                if (i == member->id) continue; // Skip self
-                
-                // Only interact with active members
-                if (!gang->members[i].alive || gang->members[i].in_prison) continue;
-                
-                // Determine if this member receives truth or disinformation
-                int sender_rank = gang->members[i].rank;
-                int receiver_rank = member->rank;
-                bool received_truth = deliver_truth(sender_rank, receiver_rank, gang->false_info_probability);
-                
-                // For secret agents, update their knowledge based on truth/falsehood
-                if (member->is_secret_agent) {
-                    // R-6: Knowledge Accumulation with configurable truth gain and false penalty
-                    if (received_truth) {
-                        // Received true information, increases knowledge by truth_gain
-                        member->knowledge += gang->truth_gain;
-                        // Also update knowledge_rate for backward compatibility
-                        member->knowledge_rate += gang->truth_gain;
-                    } else {
-                        // Received false information, decreases knowledge by false_penalty
-                        member->knowledge -= gang->false_penalty;
-                        // Also update knowledge_rate for backward compatibility
-                        member->knowledge_rate -= gang->false_penalty;
-                    }
-                    
-                    // R-5: Agents are unaware of each other - treat all members as regular members
-                    // Secret agent doesn't know if the other member is an agent too
-                    
-                    // Ensure knowledge stays within bounds
-                    if (member->knowledge < 0) {
-                        member->knowledge = 0;
-                    } else if (member->knowledge > 100) {
-                        member->knowledge = 100;
-                    }
-                    
-                    // Ensure knowledge_rate stays within bounds for backward compatibility
-                    if (member->knowledge_rate < 0) {
-                        member->knowledge_rate = 0;
-                    } else if (member->knowledge_rate > 100) {
-                        member->knowledge_rate = 100;
-                    }
-                } else {
-                    // For regular members, just adjust their knowledge normally
-                    if (received_truth) {
-                        member->knowledge += 5;
-                    } else {
-                        member->knowledge -= 3;
-                    }
-                    
-                    // Ensure knowledge stays within bounds
-                    if (member->knowledge < 0) {
-                        member->knowledge = 0;
-                    } else if (member->knowledge > 100) {
-                        member->knowledge = 100;
-                    }
-                }
-            }
-            
-            // If member is a secret agent, potentially report to police
-            if (member->is_secret_agent) {
-                
-                // Report to police if suspicion is high enough
-                if (member->knowledge_rate >= gang->required_preparation_level / 2) {
-                    // Create intelligence report
-                    IntelligenceReport report;
-                        report.gang_id = gang->id;
-                        report.agent_id = member->id;
-                        report.suspected_target = gang->current_target;
-                        report.suspicion_level = member->knowledge_rate;
-                        report.is_reliable = member->rank > (gang->num_ranks / 2);
-                        
-                        // Submit report to police through message queue
-                        int report_queue_id = gang->report_queue_id;
-                        if (report_queue_id > 0) {
-                            if (send_report(report_queue_id, report) == 0) {
-                                log_message("Agent %d in gang %d submitted a report with suspicion level %d", 
-                                           member->id, gang->id, member->knowledge_rate);
-                            } else {
-                                // If sending fails, we'll retry later
-                                log_message("Agent %d in gang %d failed to submit report - will retry later", 
-                                           member->id, gang->id);
-                            }
-                        }
-                    }
-            }
+        bool parked = gang->is_in_prison;
+        if (parked) {
+            task_pool_park(gang->pool, event);
         }
         pthread_mutex_unlock(&gang->gang_mutex);
-        
-        // Sleep to avoid busy waiting
-        usleep(500000); // 0.5 seconds between actions
+        if (parked) {
+            return;
+        }
     }
     
-    return NULL;
+    // Increase preparation level
+    IntelligenceReport report;
+    rng_use_stream(&gang->member_streams[member_id]);
+    if (gang_member_tick(gang, member_id, &report)) {
+        // Submit report to police through the report ring
+        int report_queue_id = gang->report_queue_id;
+        if (report_queue_id >= 0) {
+            if (send_report(report_queue_id, report) == 0) {
+                log_message("Agent %d in gang %d submitted a report with suspicion level %d", 
+                           member_id, gang->id, report.suspicion_level);
+            } else {
+                // If sending fails, we'll retry later
+                log_message("Agent %d in gang %d failed to submit report - will retry later", 
+                           member_id, gang->id);
+            }
+        }
+    }
+    rng_use_stream(NULL);
+    
+    task_pool_schedule(gang->pool, sim_clock_now_ms() + MEMBER_TICK_UNITS * SIM_TIME_UNIT_MS,
+                       EVENT_MEMBER_TICK, gang->id, member_id);
+}
+
+// Average preparation as a percentage of the required level, from the
+// running total. Callers needing a value consistent with the current
+// mission use gang_average_preparation or hold a mission transition.
+static int preparation_percent(Gang* gang) {
+    long long total_prep = atomic_load_explicit(&gang->total_preparation, memory_order_relaxed);
+    long long max_possible_prep = (long long)gang->num_members * gang->required_preparation_level;
+    return max_possible_prep > 0 ? (int)((total_prep * 100) / max_possible_prep) : 0;
 }
 
 // Plan a new mission for the gang
 void plan_new_mission(Gang* gang, SimulationConfig config) {
-    pthread_mutex_lock(&gang->gang_mutex);
+    begin_mission_transition(gang);
     
     // Reset preparation levels
     for (int i = 0; i < gang->num_members; i++) {
-        gang->members[i].preparation_level = 0;
+        atomic_store_explicit(&gang->member_data.preparation_level[i], 0, memory_order_relaxed);
     }
+    atomic_store_explicit(&gang->total_preparation, 0, memory_order_relaxed);
+    
+    // Pick up any change to the exchange parameters for this mission
+    refresh_truth_table(gang);
     
     // Select a random target - make sure it's truly random by using NUM_CRIME_TYPES-1
     // NUM_CRIME_TYPES is the last entry in the enum, not a valid crime type
     gang->current_target = (CrimeType)random_int(0, NUM_CRIME_TYPES - 1);
     
     // Debug log to verify crime type assignment
-    printf("Gang %d selected target crime: %s (enum value: %d)\n", 
-           gang->id, crime_type_to_string(gang->current_target), gang->current_target);
+    log_message("Gang %d selected target crime: %s (enum value: %d)", 
+                gang->id, crime_type_to_string(gang->current_target), gang->current_target);
     
     // Set preparation time
     gang->preparation_time = random_int(config.preparation_time_min, config.preparation_time_max);
@@ -211,26 +589,23 @@ void plan_new_mission(Gang* gang, SimulationConfig config) {
     // Set required preparation level
     gang->required_preparation_level = random_int(config.min_preparation_level, config.max_preparation_level);
     
+    // Preparation was reset and the required level changed, so every score may have
+    rebuild_suspects(gang);
+    
     log_message("Gang %d planning new mission: %s (Prep time: %d, Required level: %d)", 
                 gang->id, crime_type_to_string(gang->current_target), 
                 gang->preparation_time, gang->required_preparation_level);
     
-    pthread_mutex_unlock(&gang->gang_mutex);
+    end_mission_transition(gang);
 }
 
 // Execute the mission
 void execute_mission(Gang* gang, SimulationConfig config) {
     // Check if all members are prepared
-    pthread_mutex_lock(&gang->gang_mutex);
+    begin_mission_transition(gang);
     
-    int total_preparation = 0;
-    int max_possible_prep = 0;
-    for (int i = 0; i < gang->num_members; i++) {
-        total_preparation += gang->members[i].preparation_level;
-        max_possible_prep += gang->required_preparation_level;
-    }
     // Calculate as percentage of required level
-    int average_preparation = max_possible_prep > 0 ? (total_preparation * 100) / max_possible_prep : 0;
+    int average_preparation = preparation_percent(gang);
     
     // Determine if mission is successful
     // Success rate increases with preparation level and preparation time
@@ -252,15 +627,10 @@ void execute_mission(Gang* gang, SimulationConfig config) {
         // Check for member deaths during mission
         for (int i = 0; i < gang->num_members; i++) {
             if (random_event(config.member_death_probability)) {
-                log_message("Gang %d member %d died during mission", gang->id, gang->members[i].id);
+                log_message("Gang %d member %d died during mission", gang->id, i);
                 
                 // Replace the dead member with a new one
-                gang->members[i].rank = 0;  // Lowest rank
-                gang->members[i].preparation_level = 0;
-                gang->members[i].knowledge_rate = 0;
-                
-                // Determine if new member is a secret agent
-                gang->members[i].is_secret_agent = random_event(config.agent_infiltration_success_rate);
+                replace_member(gang, i, config);
             }
         }
     }
@@ -269,115 +639,76 @@ void execute_mission(Gang* gang, SimulationConfig config) {
         log_message("Gang %d failed to execute mission: %s", 
                     gang->id, crime_type_to_string(gang->current_target));
         
-        // Investigate for secret agents if they fail too many times
-        if (gang->thwarted_missions % 2 == 0) {
-            investigate_for_agents(gang, config);
-        }
-    }
-    
-    pthread_mutex_unlock(&gang->gang_mutex);
-}
-
-// Investigate for secret agents
-void investigate_for_agents(Gang* gang, SimulationConfig config) {
-    log_message("Gang %d starting internal investigation", gang->id);
-    
-    // Factors in investigation
-    typedef struct {
-        int member_id;
-        int suspicion_score;
-        bool is_agent;
-        int rank;
-        int prep_level;
-        int knowledge_rate;
-    } SuspiciousAgent;
-    
-    // First, copy member data with minimal mutex holding time
-    pthread_mutex_lock(&gang->gang_mutex);
-    int num_members = gang->num_members;
-    int num_ranks = gang->num_ranks;
-    int required_prep = gang->required_preparation_level;
-    int gang_id = gang->id;
-    
-    // Create temporary copies of member data to avoid holding mutex during investigation
-    typedef struct {
-        int preparation_level;
-        int knowledge_rate;
-        int rank;
-        bool is_secret_agent;
-    } MemberSnapshot;
-    
-    MemberSnapshot* member_snapshots = (MemberSnapshot*)malloc(num_members * sizeof(MemberSnapshot));
-    if (member_snapshots == NULL) {
-        log_message("Gang %d: Failed to allocate memory for investigation", gang->id);
-        pthread_mutex_unlock(&gang->gang_mutex);
-        return;
     }
     
-    // Copy member data quickly
-    for (int i = 0; i < num_members; i++) {
-        member_snapshots[i].preparation_level = gang->members[i].preparation_level;
-        member_snapshots[i].knowledge_rate = gang->members[i].knowledge_rate;
-        member_snapshots[i].rank = gang->members[i].rank;
-        member_snapshots[i].is_secret_agent = gang->members[i].is_secret_agent;
-    }
-    pthread_mutex_unlock(&gang->gang_mutex);
+    // Investigate for secret agents if they fail too many times.
+    // investigate_for_agents starts its own transition, so end this one first.
+    bool needs_investigation = !mission_success && gang->thwarted_missions % 2 == 0;
+    end_mission_transition(gang);
     
-    // Now do the investigation work WITHOUT holding the mutex
-    SuspiciousAgent* suspects = (SuspiciousAgent*)malloc(num_members * sizeof(SuspiciousAgent));
-    if (suspects == NULL) {
-        log_message("Gang %d: Failed to allocate memory for suspects", gang_id);
-        free(member_snapshots);
-        return;
+    if (needs_investigation) {
+        investigate_for_agents(gang, config);
     }
+}
+
+// Suspect picked for interrogation
+typedef struct {
+    int member_id;
+    int suspicion_score;
+} Suspect;
+
+// Copy up to k of the most suspicious members scoring above
+// SUSPECT_SCORE_THRESHOLD, most suspicious first, without disturbing the
+// heap. Walks the heap best-first, so it costs O(k^2) for small k whatever
+// the gang size. The caller holds the heap lock.
+static int top_suspects(Gang* gang, Suspect* suspects, int k) {
+    SuspectHeap* heap = &gang->suspects;
+    const int* suspicion = gang->member_data.suspicion;
+    int candidates[2 * INVESTIGATION_TOP_K + 1];  // Heap slots whose parents were taken
+    int num_candidates = gang->num_members > 0 ? 1 : 0;
+    int found = 0;
+    candidates[0] = 0;
     
-    int num_suspects = 0;
-    
-    // First phase: Calculate suspicion scores based on multiple factors
-    for (int i = 0; i < num_members; i++) {
-        MemberSnapshot* member = &member_snapshots[i];
-        
-        // Base suspicion score
-        int suspicion_score = 0;
-        
-        // 1. Low preparation level may indicate lack of commitment
-        if (member->preparation_level < (required_prep / 2)) {
-            suspicion_score += 20;
+    while (found < k && num_candidates > 0) {
+        int best = 0;
+        for (int i = 1; i < num_candidates; i++) {
+            if (suspect_before(gang, heap->members[candidates[i]], heap->members[candidates[best]])) {
+                best = i;
+            }
         }
+        int slot = candidates[best];
+        candidates[best] = candidates[--num_candidates];
         
-        // 2. Newer members (lower ranks) are more suspicious
-        suspicion_score += (num_ranks - member->rank) * 5;
-        
-        // 3. Check for suspicious behavior patterns (could be expanded)
-        if (member->knowledge_rate > 80 && member->rank < 2) {
-            // Low-rank members shouldn't know too much
-            suspicion_score += 25;
+        int member_id = heap->members[slot];
+        if (suspicion[member_id] <= SUSPECT_SCORE_THRESHOLD) {
+            break;
         }
+        suspects[found].member_id = member_id;
+        suspects[found].suspicion_score = suspicion[member_id];
+        found++;
         
-        // If suspicion score is high enough, add to list of suspects
-        if (suspicion_score > 30) {
-            suspects[num_suspects].member_id = i;
-            suspects[num_suspects].suspicion_score = suspicion_score;
-            suspects[num_suspects].is_agent = member->is_secret_agent;
-            suspects[num_suspects].rank = member->rank;
-            suspects[num_suspects].prep_level = member->preparation_level;
-            suspects[num_suspects].knowledge_rate = member->knowledge_rate;
-            num_suspects++;
+        for (int child = 2 * slot + 1; child <= 2 * slot + 2 && child < gang->num_members; child++) {
+            candidates[num_candidates++] = child;
         }
     }
+    return found;
+}
+
+// Investigate for secret agents. Suspicion scores are kept current by the
+// members' ticks, so this only reads the top of the suspect heap.
+void investigate_for_agents(Gang* gang, SimulationConfig config) {
+    log_message("Gang %d starting internal investigation", gang->id);
     
-    log_message("Gang %d identified %d suspicious members", gang_id, num_suspects);
+    int gang_id = gang->id;
+    MemberStore* m = &gang->member_data;
+    Suspect suspects[INVESTIGATION_TOP_K];
     
-    // Second phase: Sort suspects by suspicion score (simple bubble sort)
-    for (int i = 0; i < num_suspects - 1; i++) {
-        for (int j = 0; j < num_suspects - i - 1; j++) {
-            if (suspects[j].suspicion_score < suspects[j + 1].suspicion_score) {
-                SuspiciousAgent temp = suspects[j];
-                suspects[j] = suspects[j + 1];
-                suspects[j + 1] = temp;
-            }
-        }
-    }
+    pthread_mutex_lock(&gang->suspects.lock);
+    int num_suspects = gang->suspects.num_suspects;
+    int num_top = top_suspects(gang, suspects, INVESTIGATION_TOP_K);
+    pthread_mutex_unlock(&gang->suspects.lock);
+    
+    log_message("Gang %d identified %d suspicious members", gang_id, num_suspects);
     
     // Interrogate suspects (starting with most suspicious) - still no mutex needed
     int agents_found = 0;
@@ -387,25 +718,12 @@ void investigate_for_agents(Gang* gang, SimulationConfig config) {
         bool should_penalize;
     } InvestigationResult;
     
-    InvestigationResult* results = (InvestigationResult*)malloc(num_suspects * sizeof(InvestigationResult));
-    if (results == NULL) {
-        log_message("Gang %d: Failed to allocate memory for results", gang_id);
-        free(suspects);
-        free(member_snapshots);
-        return;
-    }
-    
+    InvestigationResult results[INVESTIGATION_TOP_K];
     int num_results = 0;
-    for (int i = 0; i < num_suspects && i < 3; i++) {  // Limit interrogations to top 3 suspects
+    for (int i = 0; i < num_top; i++) {
         int member_id = suspects[i].member_id;
-        
-        // Validate member_id to prevent array bounds issues
-        if (member_id < 0 || member_id >= num_members) {
-            log_message("Gang %d: Invalid member_id %d in investigation", gang_id, member_id);
-            continue;
-        }
-        
-        int rank = suspects[i].rank;
+        bool is_agent = m->is_secret_agent[member_id];
+        int rank = m->rank[member_id];
         
         // Probability of uncovering agent depends on suspicion score and rank
         int discovery_chance = 20 + (rank * 10) + (suspects[i].suspicion_score / 5);
@@ -413,7 +731,7 @@ void investigate_for_agents(Gang* gang, SimulationConfig config) {
         // Cap at 90%
         if (discovery_chance > 90) discovery_chance = 90;
         
-        if (suspects[i].is_agent && random_event(discovery_chance)) {
+        if (is_agent && random_event(discovery_chance)) {
             log_message("Gang %d interrogated and uncovered secret agent %d (rank %d, suspicion: %d)", 
                       gang_id, member_id, rank, suspects[i].suspicion_score);
             
@@ -422,7 +740,7 @@ void investigate_for_agents(Gang* gang, SimulationConfig config) {
             results[num_results].should_penalize = false;
             num_results++;
             agents_found++;
-        } else if (!suspects[i].is_agent) {
+        } else if (!is_agent) {
             log_message("Gang %d interrogated innocent member %d (rank %d, suspicion: %d)", 
                       gang_id, member_id, rank, suspects[i].suspicion_score);
             
@@ -438,45 +756,247 @@ void investigate_for_agents(Gang* gang, SimulationConfig config) {
     }
     
     // Check for paranoia increase
-    int actual_agents = 0;
-    for (int i = 0; i < num_members; i++) {
-        if (member_snapshots[i].is_secret_agent) {
-            actual_agents++;
-        }
-    }
-    
-    if (agents_found == 0 && actual_agents > 0) {
+    if (agents_found == 0 && gang->num_agents > 0) {
         log_message("Gang %d failed to find any agents, paranoia increasing", gang_id);
     }
     
-    // Now apply the results - lock mutex only briefly to update gang state
-    pthread_mutex_lock(&gang->gang_mutex);
+    // Now apply the results in a short transition
+    begin_mission_transition(gang);
     for (int i = 0; i < num_results; i++) {
         int member_id = results[i].member_id;
         
-        // Double-check bounds again with current gang state
-        if (member_id >= 0 && member_id < gang->num_members) {
-            if (results[i].should_execute) {
-                // Execute the agent
-                gang->executed_agents++;
-                
-                // Replace the agent with a new member
-                gang->members[member_id].rank = 0;  // Lowest rank
-                gang->members[member_id].preparation_level = 0;
-                gang->members[member_id].knowledge_rate = 0;
-                gang->members[member_id].is_secret_agent = random_event(config.agent_infiltration_success_rate);
-            } else if (results[i].should_penalize) {
-                // Penalize innocent member
-                gang->members[member_id].preparation_level = (gang->members[member_id].preparation_level * 3) / 4;
+        if (results[i].should_execute) {
+            // Execute the agent
+            gang->executed_agents++;
+            
+            // Replace the agent with a new member
+            replace_member(gang, member_id, config);
+        } else if (results[i].should_penalize) {
+            // Penalize innocent member
+            atomic_int* preparation_level = &gang->member_data.preparation_level[member_id];
+            int previous_level = atomic_load_explicit(preparation_level, memory_order_relaxed);
+            int penalized = (previous_level * 3) / 4;
+            atomic_store_explicit(preparation_level, penalized, memory_order_relaxed);
+            atomic_fetch_sub_explicit(&gang->total_preparation, previous_level - penalized, memory_order_relaxed);
+            refresh_suspicion(gang, member_id);
+        }
+    }
+    end_mission_transition(gang);
+}
+
+// One iteration of the gang process loop: arrest notifications, preparation,
+// mission execution and prison countdown. Returns how many simulation time
+// units to wait before the next iteration, or GANG_STEP_DONE once the
+// simulation is over.
+int gang_process_step(Gang* gang, GangSchedule* schedule, SharedState* shm, SimulationConfig config) {
+    int gang_id = gang->id;
+    
+    // Whoever crosses a termination limit ends the simulation
+    if (simulation_has_ended(shm)) {
+        return GANG_STEP_DONE;
+    }
+    
+    GangSlot* slot = shared_gang_slot(shm, gang_id);
+    if (slot == NULL) {
+        log_message("Gang %d has no status slot in shared memory", gang_id);
+        return GANG_STEP_DONE;
+    }
+    GangStatus* status = &slot->status;
+    
+    // Check for a new arrest order from the police. The acquire pairs with
+    // the police's release of arrests, so prison_time is the one it set.
+    unsigned int arrests = atomic_load_explicit(&slot->command.arrests, memory_order_acquire);
+    if (arrests != atomic_load_explicit(&status->arrests_seen, memory_order_relaxed)) {
+        // Gang has been arrested - process notification
+        gang->is_in_prison = true;
+        gang->prison_time_remaining = atomic_load_explicit(&slot->command.prison_time, memory_order_relaxed);
+        atomic_store_explicit(&status->arrests_seen, arrests, memory_order_relaxed);
+        
+        // Reset mission planning
+        schedule->time_spent_preparing = 0;
+        schedule->mission_planned = false;
+        
+        // Member ticks see is_in_prison and park themselves
+        log_message("Gang %d has been arrested, %d members sent to prison for %d time units",
+                   gang_id, gang->num_members, gang->prison_time_remaining);
+    }
+    
+    // Publish where the gang stands for the visualizer
+    if (gang->publish_preparation) {
+        GangProgress progress;
+        progress.preparation_level = gang_average_preparation(gang);
+        progress.current_target = gang->current_target;
+        progress.num_members = gang->num_members;
+        progress.num_agents = gang->num_agents;
+        progress.in_prison = gang->is_in_prison;
+        progress.prison_time_remaining = gang->prison_time_remaining;
+        publish_gang_progress(status, &progress);
+    }
+    
+    if (gang->is_in_prison) {
+        // Gang is in prison, decrease prison time
+        gang->prison_time_remaining--;
+        if (gang->prison_time_remaining <= 0) {
+            gang->is_in_prison = false;
+            
+            log_message("Gang %d has been released from prison", gang_id);
+            
+            // Resume the member ticks parked while the gang was in prison
+            pthread_mutex_lock(&gang->gang_mutex);
+            if (gang->pool != NULL) {
+                task_pool_unpark(gang->pool, gang_id);
             }
+            pthread_mutex_unlock(&gang->gang_mutex);
         }
+        return PRISON_STEP_UNITS;
     }
-    pthread_mutex_unlock(&gang->gang_mutex);
     
-    // Free allocated memory
-    free(results);
-    free(suspects);
-    free(member_snapshots);
+    if (!schedule->mission_planned) {
+        // Plan new mission if we don't have one
+        plan_new_mission(gang, config);
+        schedule->time_spent_preparing = 0;
+        schedule->mission_planned = true;
+        return 0;
+    }
+    
+    // Check if preparation time has elapsed
+    if (schedule->time_spent_preparing >= gang->preparation_time) {
+        // Store previous mission counts to detect changes
+        int prev_successful = gang->successful_missions;
+        int prev_thwarted = gang->thwarted_missions;
+        int prev_executed = gang->executed_agents;
+        
+        // Another process may have ended the simulation while we prepared
+        if (simulation_has_ended(shm)) {
+            return GANG_STEP_DONE;
+        }
+        
+        // Execute mission
+        execute_mission(gang, config);
+        
+        // Add the outcome to this gang's counters in shared memory, claiming
+        // it first so the totals stop exactly at their limits
+        if (gang->successful_missions > prev_successful &&
+            claim_outcomes(shm, &shm->claims.successful_missions, 1, config.max_successful_plans) > 0) {
+            atomic_fetch_add(&status->successful_missions, 1);
+            log_message("Gang %d mission succeeded - total successful missions: %d", 
+                       gang_id, shared_totals(shm).successful_missions);
+        }
+        if (gang->thwarted_missions > prev_thwarted &&
+            claim_outcomes(shm, &shm->claims.thwarted_missions, 1, config.max_thwarted_plans) > 0) {
+            atomic_fetch_add(&status->thwarted_missions, 1);
+            log_message("Gang %d mission failed - total thwarted missions: %d", 
+                       gang_id, shared_totals(shm).thwarted_missions);
+        }
+        if (gang->executed_agents > prev_executed) {
+            int executed = claim_outcomes(shm, &shm->claims.executed_agents,
+                                          gang->executed_agents - prev_executed,
+                                          config.max_executed_agents);
+            if (executed > 0) {
+                atomic_fetch_add(&status->executed_agents, executed);
+                log_message("Gang %d executed %d agents - total executed agents: %d", 
+                           gang_id, executed, shared_totals(shm).executed_agents);
+            }
+        }
+        if (check_simulation_limits(shm, config)) {
+            return GANG_STEP_DONE;
+        }
+        
+        // Plan next mission
+        plan_new_mission(gang, config);
+        schedule->time_spent_preparing = 0;
+        return 0;
+    }
+    
+    // Continue preparing
+    schedule->time_spent_preparing++;
+    
+    // Log preparation status periodically
+    if (schedule->time_spent_preparing % 2 == 0) {
+        int avg_prep = gang_average_preparation(gang);
+        
+        log_message("Gang %d preparing for %s: %d/%d time units, %d%% prepared", 
+                   gang->id, crime_type_to_string(gang->current_target),
+                   schedule->time_spent_preparing, gang->preparation_time, avg_prep);
+    }
+    
+    // Wait to simulate time passing and avoid busy waiting
+    return PREPARATION_STEP_UNITS;
+}
+
+// Replace a dead or executed member with a new recruit at the lowest rank.
+// The caller must be inside a mission transition.
+void replace_member(Gang* gang, int member_id, SimulationConfig config) {
+    MemberStore* m = &gang->member_data;
+    if (member_is_active(gang, member_id)) {
+        gang->active_by_rank[m->rank[member_id]]--;
+        gang->active_by_rank[0]++;
+    }
+    m->rank[member_id] = 0;  // Lowest rank
+    int previous_level = atomic_exchange_explicit(&m->preparation_level[member_id], 0, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&gang->total_preparation, previous_level, memory_order_relaxed);
+    atomic_store_explicit(&m->knowledge_rate[member_id], 0, memory_order_relaxed);
+    
+    // Determine if new member is a secret agent
+    gang->num_agents -= m->is_secret_agent[member_id];
+    m->is_secret_agent[member_id] = random_event(config.agent_infiltration_success_rate);
+    gang->num_agents += m->is_secret_agent[member_id];
+    
+    refresh_suspicion(gang, member_id);
+}
+
+// Whether no mission transition started since stable_mission_version returned version
+static bool mission_version_unchanged(Gang* gang, unsigned int version) {
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&gang->mission_version, memory_order_relaxed) == version;
+}
+
+// Copy every member into snapshots (num_members entries) without taking a
+// lock. Each entry is consistent with one completed tick of that member, and
+// the whole copy belongs to one mission: it is retried if a mission
+// transition ran meanwhile. Member ticks never wait for readers. Returns the
+// mission version the snapshot belongs to. Must not be called inside a
+// mission transition.
+unsigned int gang_snapshot_members(Gang* gang, MemberSnapshot* snapshots) {
+    MemberStore* m = &gang->member_data;
+    unsigned int version;
+    
+    do {
+        version = stable_mission_version(gang);
+        
+        for (int i = 0; i < gang->num_members; i++) {
+            MemberSnapshot* snapshot = &snapshots[i];
+            unsigned int seq;
+            do {
+                seq = atomic_load_explicit(&m->seq[i], memory_order_acquire);
+                snapshot->preparation_level = atomic_load_explicit(&m->preparation_level[i], memory_order_relaxed);
+                snapshot->knowledge = atomic_load_explicit(&m->knowledge[i], memory_order_relaxed);
+                snapshot->knowledge_rate = atomic_load_explicit(&m->knowledge_rate[i], memory_order_relaxed);
+                atomic_thread_fence(memory_order_acquire);
+            } while ((seq & 1) || atomic_load_explicit(&m->seq[i], memory_order_relaxed) != seq);
+            
+            snapshot->rank = m->rank[i];
+            snapshot->is_secret_agent = m->is_secret_agent[i];
+            snapshot->is_active = member_is_active(gang, i);
+        }
+    } while (!mission_version_unchanged(gang, version));
+    
+    return version;
+}
+
+// Average preparation as a percentage of the current mission's required
+// level. O(1) and lock-free, so any thread may call it (for logging or the
+// visualizer) except from inside a mission transition.
+int gang_average_preparation(Gang* gang) {
+    unsigned int version;
+    int average;
+    
+    do {
+        version = stable_mission_version(gang);
+        average = preparation_percent(gang);
+    } while (!mission_version_unchanged(gang, version));
+    
+    return average;
 }
 
 // Clean up gang resources
@@ -484,33 +1004,34 @@ void cleanup_gang(Gang* gang) {
     // Set gang as inactive
     gang->is_active = false;
     
-    // Signal any waiting threads
-    pthread_cond_broadcast(&gang->gang_cond);
-    
-    // Wait for all threads to finish
-    for (int i = 0; i < gang->num_members; i++) {
-        pthread_join(gang->members[i].thread, NULL);
+    // Stop the task pool; member ticks already running finish first
+    if (gang->pool != NULL) {
+        task_pool_shutdown(gang->pool);
+        free(gang->pool);
+        gang->pool = NULL;
     }
     
-    // Destroy mutex and condition variable
+    // Destroy mutex
     pthread_mutex_destroy(&gang->gang_mutex);
-    pthread_cond_destroy(&gang->gang_cond);
     
     // Free allocated memory
-    free(gang->members);
+    free_member_store(&gang->member_data);
+    free(gang->member_streams);
+    free(gang->active_by_rank);
+    free_suspect_heap(&gang->suspects);
+    free(gang->truth_table);
     
     log_message("Gang %d resources cleaned up", gang->id);
 }
 
-// Helper function to determine if truth is delivered based on rank distance
-// Returns true if truthful information should be delivered, false for disinformation
-bool deliver_truth(int sender_rank, int receiver_rank, int false_info_probability) {
+// Probability (in percent) that a sender delivers truthful information to a receiver
+int truth_probability(int sender_rank, int receiver_rank, int false_info_probability) {
     // Calculate rank distance
     int rank_distance = abs(sender_rank - receiver_rank);
     
     // If sender and receiver are the same rank, always deliver truth
     if (rank_distance == 0) {
-        return true;
+        return 100;
     }
     
     // Base probability affected by the gang's false_info_probability config
@@ -526,7 +1047,7 @@ bool deliver_truth(int sender_rank, int receiver_rank, int false_info_probabilit
             probability_of_truth = 30;
         }
         
-        return random_event(probability_of_truth);
+        return probability_of_truth;
     } else {
         // If sender has lower rank, they may not have full information
         // The lower the sender's rank compared to receiver, the less likely they have truth
@@ -537,6 +1058,41 @@ bool deliver_truth(int sender_rank, int receiver_rank, int false_info_probabilit
             probability_of_truth = 20;
         }
         
-        return random_event(probability_of_truth);
+        return probability_of_truth;
     }
 }
+
+// Helper function to determine if truth is delivered based on rank distance
+// Returns true if truthful information should be delivered, false for disinformation
+bool deliver_truth(int sender_rank, int receiver_rank, int false_info_probability) {
+    return random_event(truth_probability(sender_rank, receiver_rank, false_info_probability));
+}
+
+// Rebuild the gang's rank-pair truth table if the inputs it was built from changed
+void refresh_truth_table(Gang* gang) {
+    if (gang->truth_table != NULL &&
+        gang->truth_table_ranks == gang->num_ranks &&
+        gang->truth_table_false_info == gang->false_info_probability) {
+        return;
+    }
+    
+    int num_ranks = gang->num_ranks;
+    if (gang->truth_table_ranks != num_ranks || gang->truth_table == NULL) {
+        free(gang->truth_table);
+        gang->truth_table = (uint32_t*)malloc(num_ranks * num_ranks * sizeof(uint32_t));
+        if (gang->truth_table == NULL) {
+            perror("Failed to allocate truth table");
+            exit(EXIT_FAILURE);
+        }
+    }
+    
+    for (int sender = 0; sender < num_ranks; sender++) {
+        for (int receiver = 0; receiver < num_ranks; receiver++) {
+            int probability = truth_probability(sender, receiver, gang->false_info_probability);
+            gang->truth_table[sender * num_ranks + receiver] = probability_threshold(probability);
+        }
+    }
+    
+    gang->truth_table_ranks = num_ranks;
+    gang->truth_table_false_info = gang->false_info_probability;
+}
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../include/headless.h"
+#include "../include/scheduler.h"
+#include "../include/gang.h"
+#include "../include/police.h"
+#include "../include/ipc.h"
+#include "../include/utils.h"
+#include "../include/sim_clock.h"
+
+// Decide whether a termination condition has been reached
+static bool simulation_finished(SharedState* state, SimulationConfig config, SimulationOutcome* outcome) {
+    // The actor that crosses a limit ends the simulation; then find which one
+    if (!simulation_has_ended(state)) {
+        return false;
+    }
+    
+    SharedTotals totals = shared_totals(state);
+    if (totals.successful_missions >= config.max_successful_plans) {
+        *outcome = OUTCOME_GANGS_WIN;
+        return true;
+    }
+    if (totals.thwarted_missions >= config.max_thwarted_plans) {
+        *outcome = OUTCOME_POLICE_WIN;
+        return true;
+    }
+    if (totals.executed_agents >= config.max_executed_agents) {
+        *outcome = OUTCOME_AGENTS_LOST;
+        return true;
+    }
+    return false;
+}
+
+// Run a whole simulation in a single thread using virtual time.
+// Gang processes, member threads and the police are replaced by events on a
+// priority queue that call the same step functions as the real-time path,
+// so no sleeping, forking or System V IPC takes place. Each simulated actor
+// draws from the same random stream it would use as a thread, keyed by the
+// seed set with rng_set_seed.
+HeadlessResult run_headless_simulation(SimulationConfig config, bool verbose) {
+    HeadlessResult result;
+    memset(&result, 0, sizeof(result));
+    result.outcome = OUTCOME_TIMEOUT;
+    
+    set_logging_enabled(verbose);
+    
+    // Determine number of gangs
+    int num_gangs = random_int(config.min_gangs, config.max_gangs);
+    result.num_gangs = num_gangs;
+    
+    // Process-local stand-in for the shared memory segment
+    size_t state_size = shared_state_size(num_gangs);   // Whole cache lines, as aligned_alloc needs
+    SharedState* state = (SharedState*)aligned_alloc(CACHE_LINE_SIZE, state_size);
+    if (state == NULL) {
+        perror("Failed to allocate headless simulation state");
+        exit(1);
+    }
+    memset(state, 0, state_size);
+    init_shared_state(state, num_gangs);
+    
+    Gang* gangs = (Gang*)malloc(num_gangs * sizeof(Gang));
+    GangSchedule* schedules = (GangSchedule*)malloc(num_gangs * sizeof(GangSchedule));
+    RngStream* gang_streams = (RngStream*)malloc(num_gangs * sizeof(RngStream));
+    if (gangs == NULL || schedules == NULL || gang_streams == NULL) {
+        perror("Failed to allocate headless gangs");
+        exit(1);
+    }
+    
+    // Report handling and the monitoring routine run on different police threads
+    RngStream police_streams[2];
+    rng_stream_init(&police_streams[0], rng_get_seed(), RNG_POLICE_STREAM, 0);
+    rng_stream_init(&police_streams[1], rng_get_seed(), RNG_POLICE_STREAM, 1);
+    
+    Police police;
+    initialize_police(&police, config);
+    police.shared_state = state;
+    
+    EventQueue queue;
+    event_queue_init(&queue, num_gangs * (config.max_members_per_gang + 1) + 1);
+    
+    // Mirror run_gang_process: initialize, then plan the first mission
+    for (int i = 0; i < num_gangs; i++) {
+        rng_stream_init(&gang_streams[i], rng_get_seed(), i, RNG_PROCESS_STREAM);
+        rng_use_stream(&gang_streams[i]);
+        
+        int num_members = random_int(config.min_members_per_gang, config.max_members_per_gang);
+        initialize_gang_state(&gangs[i], i, num_members, config.gang_ranks, config);
+        plan_new_mission(&gangs[i], config);
+        
+        schedules[i].time_spent_preparing = 0;
+        schedules[i].mission_planned = true;
+        result.total_members += num_members;
+        
+        event_queue_push(&queue, 0, EVENT_GANG_STEP, i, -1);
+        for (int m = 0; m < num_members; m++) {
+            event_queue_push(&queue, 0, EVENT_MEMBER_TICK, i, m);
+        }
+    }
+    event_queue_push(&queue, 0, EVENT_POLICE_ROUTINE, -1, -1);
+    
+    SimEvent event;
+    while (event_queue_pop(&queue, &event)) {
+        if (event.time > HEADLESS_MAX_VIRTUAL_MS) {
+            break;
+        }
+        result.virtual_time_ms = event.time;
+        result.events_processed++;
+        police.virtual_now_ms = event.time;
+        
+        switch (event.type) {
+            case EVENT_MEMBER_TICK: {
+                Gang* gang = &gangs[event.gang_id];
+                
+                // Members are blocked while their gang is in prison
+                if (!gang->is_in_prison) {
+                    IntelligenceReport report;
+                    rng_use_stream(&gang->member_streams[event.member_id]);
+                    bool has_report = gang_member_tick(gang, event.member_id, &report);
+                    
+                    // Reports reach the police as soon as they are sent
+                    if (has_report) {
+                        report.time_ms = event.time;
+                        rng_use_stream(&police_streams[0]);
+                        police_handle_report(&police, report, config);
+                    }
+                }
+                event_queue_push(&queue, event.time + MEMBER_TICK_UNITS * SIM_TIME_UNIT_MS, EVENT_MEMBER_TICK,
+                                 event.gang_id, event.member_id);
+                break;
+            }
+            case EVENT_GANG_STEP: {
+                rng_use_stream(&gang_streams[event.gang_id]);
+                int delay = gang_process_step(&gangs[event.gang_id], &schedules[event.gang_id],
+                                              state, config);
+                if (delay != GANG_STEP_DONE) {
+                    event_queue_push(&queue, event.time + (long long)delay * SIM_TIME_UNIT_MS,
+                                     EVENT_GANG_STEP, event.gang_id, -1);
+                }
+                break;
+            }
+            case EVENT_POLICE_ROUTINE:
+                rng_use_stream(&police_streams[1]);
+                police_routine_step(&police, config);
+                event_queue_push(&queue, event.time + POLICE_ANALYSIS_UNITS * SIM_TIME_UNIT_MS,
+                                 EVENT_POLICE_ROUTINE, -1, -1);
+                break;
+            default:
+                break;
+        }
+        
+        if (simulation_finished(state, config, &result.outcome)) {
+            break;
+        }
+    }
+    
+    SharedTotals totals = shared_totals(state);
+    result.successful_missions = totals.successful_missions;
+    result.thwarted_missions = totals.thwarted_missions;
+    result.executed_agents = totals.executed_agents;
+    for (int i = 0; i < num_gangs; i++) {
+        for (int m = 0; m < gangs[i].num_members; m++) {
+            if (member_is_agent(&gangs[i], m)) {
+                result.agents_remaining++;
+            }
+        }
+    }
+    
+    // Clean up
+    rng_use_stream(NULL);
+    event_queue_destroy(&queue);
+    for (int i = 0; i < num_gangs; i++) {
+        cleanup_gang(&gangs[i]);
+    }
+    free(gang_streams);
+    cleanup_police(&police);
+    free(schedules);
+    free(gangs);
+    free(state);
+    
+    set_logging_enabled(true);
+    return result;
+}
+
+// Convert an outcome to a readable string
+const char* outcome_to_string(SimulationOutcome outcome) {
+    switch (outcome) {
+        case OUTCOME_GANGS_WIN:
+            return "Gangs win";
+        case OUTCOME_POLICE_WIN:
+            return "Police win";
+        case OUTCOME_AGENTS_LOST:
+            return "Agents lost";
+        case OUTCOME_TIMEOUT:
+            return "Timeout";
+        default:
+            return "Unknown";
+    }
+}
+
+// Print the summary of a headless run
+void print_headless_result(HeadlessResult result) {
+    printf("=== Headless Simulation Result ===\n");
+    printf("  - Outcome: %s\n", outcome_to_string(result.outcome));
+    printf("  - Simulated time: %.1f time units\n", result.virtual_time_ms / (double)SIM_TIME_UNIT_MS);
+    printf("  - Events processed: %lld\n", result.events_processed);
+    printf("  - Gangs: %d (%d members)\n", result.num_gangs, result.total_members);
+    printf("  - Successful missions: %d\n", result.successful_missions);
+    printf("  - Thwarted missions: %d\n", result.thwarted_missions);
+    printf("  - Executed agents: %d\n", result.executed_agents);
+    printf("  - Agents remaining: %d\n", result.agents_remaining);
+    printf("==================================\n");
+}
@@ -1,181 +1,605 @@
+#define _GNU_SOURCE  // memfd_create and MFD_HUGETLB for reserved huge pages
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
-#include <sys/msg.h>
 #include <sys/shm.h>
-#include <sys/sem.h>
 #include <errno.h>
 #include "../include/ipc.h"
 #include "../include/utils.h"
 
-// Define keys for IPC resources
-#define REPORT_QUEUE_KEY 0x1234
-#define SHARED_MEMORY_KEY 0x5678
-#define SEMAPHORE_KEY 0x9ABC
+// Huge page size the POSIX segment is rounded up to when huge pages are
+// requested (the x86-64 default)
+#define SHM_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
 
-// Size of shared memory segment
-#define SHARED_MEMORY_SIZE sizeof(SharedState)
+// Report ring attached in this process and the segment it came from. The
+// parent attaches in create_report_queue before forking, so gangs and police
+// inherit the mapping; report_ring only attaches for other callers.
+static pthread_mutex_t ring_attach_lock = PTHREAD_MUTEX_INITIALIZER;
+static ReportRing* attached_ring = NULL;
+static atomic_int attached_ring_id = -1;
 
-// Number of semaphores in the set
-#define NUM_SEMAPHORES 1
-
-// Create message queue for intelligence reports
-int create_report_queue() {
-    int queue_id = msgget(REPORT_QUEUE_KEY, IPC_CREAT | 0666);
+// The report ring in segment queue_id, attaching it on first use
+static ReportRing* report_ring(int queue_id) {
+    if (atomic_load_explicit(&attached_ring_id, memory_order_acquire) == queue_id) {
+        return attached_ring;
+    }
     
+    pthread_mutex_lock(&ring_attach_lock);
+    if (atomic_load_explicit(&attached_ring_id, memory_order_relaxed) != queue_id) {
+        ReportRing* ring = (ReportRing*)shmat(queue_id, NULL, 0);
+        if (ring == (ReportRing*)-1) {
+            perror("Failed to attach to report ring");
+            exit(1);
+        }
+        attached_ring = ring;
+        atomic_store_explicit(&attached_ring_id, queue_id, memory_order_release);
+    }
+    pthread_mutex_unlock(&ring_attach_lock);
+    return attached_ring;
+}
+
+// Create the shared memory ring for intelligence reports. The segment is
+// private to this run: processes forked afterwards inherit its id, and no
+// other run can find or remove it. Returns its segment id, which the report
+// functions take as queue_id.
+int create_report_queue(void) {
+    int queue_id = shmget(IPC_PRIVATE, sizeof(ReportRing), IPC_CREAT | 0600);
     if (queue_id == -1) {
-        perror("Failed to create message queue");
+        perror("Failed to create report ring");
         exit(1);
     }
     
-    log_message("Created message queue with ID %d", queue_id);
+    // Every slot starts free for the ticket that first lands on it
+    ReportRing* ring = report_ring(queue_id);
+    atomic_store(&ring->tail, 0);
+    atomic_store(&ring->dropped, 0);
+    atomic_store(&ring->head, 0);
+    atomic_store(&ring->consumer_waiting, 0);
+    atomic_store(&ring->wakeups, 0);
+    atomic_store(&ring->closed, 0);
+    for (unsigned int i = 0; i < REPORT_RING_CAPACITY; i++) {
+        atomic_store(&ring->slots[i].sequence, i);
+    }
+    
+    log_message("Created report ring with ID %d", queue_id);
     return queue_id;
 }
 
-// Destroy message queue
+// Destroy the report ring
 void destroy_report_queue(int queue_id) {
-    if (msgctl(queue_id, IPC_RMID, NULL) == -1) {
-        perror("Failed to destroy message queue");
+    // Leave the ring attached: threads of this process may still be sending
+    unsigned int dropped = 0;
+    if (atomic_load(&attached_ring_id) == queue_id) {
+        dropped = atomic_load(&attached_ring->dropped);
+    }
+    
+    if (shmctl(queue_id, IPC_RMID, NULL) == -1) {
+        perror("Failed to destroy report ring");
     }
     else {
-        log_message("Destroyed message queue with ID %d", queue_id);
+        log_message("Destroyed report ring with ID %d (%u reports dropped while full)", queue_id, dropped);
     }
 }
 
-// Send an intelligence report
+// Send an intelligence report. Claims the next ticket, fills the slot and
+// publishes it; the only system call is a wake-up when the police is
+// asleep. Returns 0, or -1 with errno EAGAIN when the ring is full.
 int send_report(int queue_id, IntelligenceReport report) {
-    ReportMessage msg;
-    msg.mtype = 1;  // Message type (can be used for filtering)
-    msg.report = report;
+    ReportRing* ring = report_ring(queue_id);
+    unsigned int ticket = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    ReportSlot* slot;
+    
+    for (;;) {
+        slot = &ring->slots[ticket & (REPORT_RING_CAPACITY - 1)];
+        int lag = (int)(atomic_load_explicit(&slot->sequence, memory_order_acquire) - ticket);
+        if (lag == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &ticket, ticket + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (lag < 0) {
+            // The police has not taken the report from a lap ago yet
+            atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+            errno = EAGAIN;
+            return -1;
+        }
+        else {
+            ticket = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        }
+    }
     
-    int result = msgsnd(queue_id, &msg, sizeof(IntelligenceReport), 0);
+    slot->time_ms = report.time_ms;
+    slot->gang_id = report.gang_id;
+    slot->agent_id = report.agent_id;
+    slot->suspicion_level = (int16_t)report.suspicion_level;
+    slot->suspected_target = (uint8_t)report.suspected_target;
+    slot->is_reliable = report.is_reliable;
+    atomic_store_explicit(&slot->sequence, ticket + 1, memory_order_release);
     
-    if (result == -1) {
-        perror("Failed to send report");
+    // Pairs with the fence in receive_report_timed: either the police sees
+    // this report before sleeping, or we see that it is waiting
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&ring->consumer_waiting, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(&ring->wakeups, 1, memory_order_relaxed);
+        futex_wake(&ring->wakeups, 1);
+    }
+    return 0;
+}
+
+// Take the oldest published report, if any. Only the police calls this.
+static bool take_report(ReportRing* ring, IntelligenceReport* report) {
+    unsigned int ticket = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    ReportSlot* slot = &ring->slots[ticket & (REPORT_RING_CAPACITY - 1)];
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != ticket + 1) {
+        return false;
     }
     
-    return result;
+    report->gang_id = slot->gang_id;
+    report->agent_id = slot->agent_id;
+    report->suspected_target = (CrimeType)slot->suspected_target;
+    report->suspicion_level = slot->suspicion_level;
+    report->is_reliable = slot->is_reliable;
+    report->time_ms = slot->time_ms;
+    
+    // Free the slot for the producer one lap ahead
+    atomic_store_explicit(&slot->sequence, ticket + REPORT_RING_CAPACITY, memory_order_release);
+    atomic_store_explicit(&ring->head, ticket + 1, memory_order_relaxed);
+    return true;
 }
 
-// Receive an intelligence report
+// Receive an intelligence report without waiting. Returns the report size,
+// or -1 with errno ENOMSG when the ring is empty.
 int receive_report(int queue_id, IntelligenceReport* report) {
-    ReportMessage msg;
-    
-    int result = msgrcv(queue_id, &msg, sizeof(IntelligenceReport), 0, IPC_NOWAIT);
+    if (!take_report(report_ring(queue_id), report)) {
+        errno = ENOMSG;
+        return -1;
+    }
+    return sizeof(IntelligenceReport);
+}
+
+// Receive an intelligence report, sleeping on the ring's futex for at most
+// about timeout_ms. Returns like receive_report: the report size, or -1 when
+// nothing arrived in time, the simulation ended (errno ECANCELED) or a
+// signal interrupted the wait.
+int receive_report_timed(int queue_id, IntelligenceReport* report, int timeout_ms) {
+    ReportRing* ring = report_ring(queue_id);
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
     
-    if (result == -1) {
-        if (errno != ENOMSG) {
-            perror("Failed to receive report");
+    int result = -1;
+    while (result == -1) {
+        if (take_report(ring, report)) {
+            return sizeof(IntelligenceReport);
+        }
+        
+        // Announce the wait, then look once more: a producer that published
+        // before seeing consumer_waiting is caught by the second look, and
+        // one that published after it bumps wakeups past the value read here.
+        // Closing the ring also bumps wakeups, after setting closed.
+        atomic_store_explicit(&ring->consumer_waiting, 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        unsigned int wakeups = atomic_load_explicit(&ring->wakeups, memory_order_acquire);
+        if (take_report(ring, report)) {
+            result = sizeof(IntelligenceReport);
+            break;
+        }
+        if (atomic_load_explicit(&ring->closed, memory_order_relaxed)) {
+            errno = ECANCELED;
+            break;
+        }
+        
+        struct timespec now, remaining;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        remaining.tv_sec = deadline.tv_sec - now.tv_sec;
+        remaining.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if (remaining.tv_nsec < 0) {
+            remaining.tv_sec--;
+            remaining.tv_nsec += 1000000000L;
+        }
+        if (remaining.tv_sec < 0) {
+            errno = ETIMEDOUT;
+            break;
+        }
+        if (futex_wait(&ring->wakeups, wakeups, &remaining) == -1 && errno == EINTR) {
+            break;
         }
-    }
-    else {
-        *report = msg.report;
     }
     
+    int saved_errno = errno;
+    atomic_store_explicit(&ring->consumer_waiting, 0, memory_order_relaxed);
+    errno = saved_errno;
     return result;
 }
 
-// Create shared memory segment
-int create_shared_memory() {
-    int shm_id = shmget(SHARED_MEMORY_KEY, SHARED_MEMORY_SIZE, IPC_CREAT | 0666);
+// Wait like receive_report_timed for a first report, then take whatever
+// else is already published without waiting, up to max_reports in total.
+// Returns the number of reports received.
+int receive_reports_timed(int queue_id, IntelligenceReport* reports, int max_reports, int timeout_ms) {
+    if (max_reports < 1 || receive_report_timed(queue_id, &reports[0], timeout_ms) == -1) {
+        return 0;
+    }
     
-    if (shm_id == -1) {
-        perror("Failed to create shared memory");
-        exit(1);
+    ReportRing* ring = report_ring(queue_id);
+    int received = 1;
+    while (received < max_reports && take_report(ring, &reports[received])) {
+        received++;
     }
+    return received;
+}
+
+// Bytes needed for the shared state of num_gangs gangs
+size_t shared_state_size(int num_gangs) {
+    return sizeof(SharedState) + (size_t)num_gangs * sizeof(GangSlot);
+}
+
+// Zero every counter and mark every gang free. The clock is initialized
+// separately with sim_clock_init.
+void init_shared_state(SharedState* shm, int num_gangs) {
+    shm->num_gangs = num_gangs;
+    atomic_init(&shm->ended, 0);
+    atomic_init(&shm->police.thwarted_missions, 0);
+    atomic_init(&shm->claims.successful_missions, 0);
+    atomic_init(&shm->claims.thwarted_missions, 0);
+    atomic_init(&shm->claims.executed_agents, 0);
     
-    log_message("Created shared memory segment with ID %d", shm_id);
-    return shm_id;
+    for (int i = 0; i < num_gangs; i++) {
+        GangSlot* slot = &shm->gangs[i];
+        atomic_init(&slot->command.arrests, 0);
+        atomic_init(&slot->command.prison_time, 0);
+        atomic_init(&slot->status.successful_missions, 0);
+        atomic_init(&slot->status.thwarted_missions, 0);
+        atomic_init(&slot->status.executed_agents, 0);
+        atomic_init(&slot->status.arrests_seen, 0);
+        atomic_init(&slot->status.progress_seq, 0);
+    }
 }
 
-// Destroy shared memory segment
-void destroy_shared_memory(int shm_id) {
-    if (shmctl(shm_id, IPC_RMID, NULL) == -1) {
-        perror("Failed to destroy shared memory");
+// Slot of a gang, or NULL if gang_id is outside the table
+GangSlot* shared_gang_slot(SharedState* shm, int gang_id) {
+    if (gang_id < 0 || gang_id >= shm->num_gangs) {
+        return NULL;
     }
-    else {
-        log_message("Destroyed shared memory segment with ID %d", shm_id);
+    return &shm->gangs[gang_id];
+}
+
+// Simulation totals, summed from the police's and every gang's counters.
+// Each counter is read on its own, so a total may miss an update that is
+// happening at the same time; it never goes backwards. The counters are
+// bumped and read sequentially consistent, so when two writers cross a
+// limit together the later one's check_simulation_limits sees both.
+SharedTotals shared_totals(SharedState* shm) {
+    SharedTotals totals;
+    totals.successful_missions = 0;
+    totals.thwarted_missions = atomic_load(&shm->police.thwarted_missions);
+    totals.executed_agents = 0;
+    
+    for (int i = 0; i < shm->num_gangs; i++) {
+        GangStatus* status = &shm->gangs[i].status;
+        totals.successful_missions += atomic_load(&status->successful_missions);
+        totals.thwarted_missions += atomic_load(&status->thwarted_missions);
+        totals.executed_agents += atomic_load(&status->executed_agents);
     }
+    return totals;
 }
 
-// Attach to shared memory
-SharedState* attach_shared_memory(int shm_id) {
-    SharedState* shm_ptr = (SharedState*)shmat(shm_id, NULL, 0);
+// Whether any termination limit from the configuration has been reached
+bool shared_limits_reached(SharedState* shm, SimulationConfig config) {
+    SharedTotals totals = shared_totals(shm);
+    return totals.successful_missions >= config.max_successful_plans ||
+           totals.thwarted_missions >= config.max_thwarted_plans ||
+           totals.executed_agents >= config.max_executed_agents;
+}
+
+// Whether the simulation has ended
+bool simulation_has_ended(SharedState* shm) {
+    return atomic_load_explicit(&shm->ended, memory_order_acquire) != 0;
+}
+
+// Close the report ring attached in this process, if any, waking the
+// police if it is asleep waiting for reports
+static void close_report_ring(void) {
+    if (atomic_load_explicit(&attached_ring_id, memory_order_acquire) == -1) {
+        return;
+    }
+    atomic_store_explicit(&attached_ring->closed, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&attached_ring->wakeups, 1, memory_order_release);
+    futex_wake(&attached_ring->wakeups, INT_MAX);
+}
+
+// End the simulation and wake every process waiting for it, including a
+// police asleep on the report ring. Only the first call wakes anyone. Safe
+// to call from a signal handler.
+void end_simulation(SharedState* shm) {
+    if (atomic_exchange_explicit(&shm->ended, 1, memory_order_acq_rel) == 0) {
+        futex_wake(&shm->ended, INT_MAX);
+        close_report_ring();
+    }
+}
+
+// Claim up to count outcomes of one kind (a field of shm->claims) before
+// counting them, so that writers racing for the last ones cannot push the
+// total past limit. Returns how many were granted: none once the limit has
+// been claimed or the simulation has ended.
+int claim_outcomes(SharedState* shm, atomic_int* claimed, int count, int limit) {
+    int current = atomic_load(claimed);
+    int granted;
+    do {
+        if (simulation_has_ended(shm) || current >= limit) {
+            return 0;
+        }
+        granted = count < limit - current ? count : limit - current;
+    } while (!atomic_compare_exchange_weak(claimed, &current, current + granted));
+    return granted;
+}
+
+// End the simulation if a termination limit has been reached. Returns
+// whether the simulation has ended, for either reason.
+bool check_simulation_limits(SharedState* shm, SimulationConfig config) {
+    if (!simulation_has_ended(shm) && shared_limits_reached(shm, config)) {
+        end_simulation(shm);
+    }
+    return simulation_has_ended(shm);
+}
+
+// Wait until the simulation ends, for at most timeout_ms. Returns whether
+// it has ended.
+bool wait_for_simulation_end(SharedState* shm, int timeout_ms) {
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    if (!simulation_has_ended(shm)) {
+        futex_wait(&shm->ended, 0, &timeout);
+    }
+    return simulation_has_ended(shm);
+}
+
+// Overwrite a gang's published progress. Only the gang's own process calls
+// this, so it needs no lock; readers retry while progress_seq is odd.
+void publish_gang_progress(GangStatus* status, const GangProgress* progress) {
+    unsigned int seq = atomic_load_explicit(&status->progress_seq, memory_order_relaxed);
+    atomic_store_explicit(&status->progress_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&status->preparation_level, progress->preparation_level, memory_order_relaxed);
+    atomic_store_explicit(&status->current_target, progress->current_target, memory_order_relaxed);
+    atomic_store_explicit(&status->num_members, progress->num_members, memory_order_relaxed);
+    atomic_store_explicit(&status->num_agents, progress->num_agents, memory_order_relaxed);
+    atomic_store_explicit(&status->in_prison, progress->in_prison, memory_order_relaxed);
+    atomic_store_explicit(&status->prison_time_remaining, progress->prison_time_remaining, memory_order_relaxed);
+    atomic_store_explicit(&status->progress_seq, seq + 2, memory_order_release);
+}
+
+// Copy a gang's latest published progress. Returns false, leaving progress
+// untouched, if the gang has not published yet.
+bool read_gang_progress(GangStatus* status, GangProgress* progress) {
+    GangProgress copy;
+    unsigned int seq;
+    do {
+        seq = atomic_load_explicit(&status->progress_seq, memory_order_acquire);
+        copy.preparation_level = atomic_load_explicit(&status->preparation_level, memory_order_relaxed);
+        copy.current_target = (CrimeType)atomic_load_explicit(&status->current_target, memory_order_relaxed);
+        copy.num_members = atomic_load_explicit(&status->num_members, memory_order_relaxed);
+        copy.num_agents = atomic_load_explicit(&status->num_agents, memory_order_relaxed);
+        copy.in_prison = atomic_load_explicit(&status->in_prison, memory_order_relaxed);
+        copy.prison_time_remaining = atomic_load_explicit(&status->prison_time_remaining, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1) || atomic_load_explicit(&status->progress_seq, memory_order_relaxed) != seq);
     
-    if (shm_ptr == (SharedState*)-1) {
-        perror("Failed to attach to shared memory");
+    if (seq == 0) {
+        return false;
+    }
+    *progress = copy;
+    return true;
+}
+
+// Backend of the shared state segment, recorded by create_shared_memory
+// and inherited by the processes forked after it. For the POSIX backend the
+// segment id is the descriptor of the shared memory object.
+static ShmBackend shm_backend = SHM_BACKEND_SYSV;
+static size_t shm_size = 0;            // Bytes mapped by attach_shared_memory (POSIX)
+static int shm_map_flags = 0;          // Extra mmap flags (POSIX)
+static bool shm_advise_huge = false;   // madvise the mapping for transparent huge pages
+static bool shm_populate_late = false; // Pre-fault after the madvise instead of with MAP_POPULATE
+static int shm_handle = -1;            // Segment id (System V) or descriptor (POSIX) created here
+static char shm_name[64] = "";         // Name of the object; empty for a huge page memfd
+static pid_t shm_owner = -1;           // Process that created the object and pre-faults it (POSIX)
+
+// Create a System V segment private to this run; forked processes inherit
+// its id
+static int create_sysv_shared_memory(size_t size) {
+    int shm_id = shmget(IPC_PRIVATE, size, IPC_CREAT | 0600);
+    if (shm_id == -1) {
+        perror("Failed to create shared memory");
         exit(1);
     }
-    
-    return shm_ptr;
+    return shm_id;
 }
 
-// Detach from shared memory
-void detach_shared_memory(SharedState* shm_ptr) {
-    if (shmdt(shm_ptr) == -1) {
-        perror("Failed to detach from shared memory");
+// Try to back the segment with reserved huge pages. Returns the memfd, or
+// -1 if the system has too few huge pages reserved.
+static int create_huge_page_memfd(size_t size) {
+    int fd = memfd_create("crime_sim", MFD_HUGETLB);
+    if (fd == -1) {
+        return -1;
+    }
+    
+    // Mapping reserves the pages, so a trial mapping shows whether they exist
+    void* trial = MAP_FAILED;
+    if (ftruncate(fd, size) == 0) {
+        trial = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (trial == MAP_FAILED) {
+        close(fd);
+        return -1;
     }
+    munmap(trial, size);
+    return fd;
 }
 
-// Create semaphore set
-int create_semaphore_set() {
-    int sem_id = semget(SEMAPHORE_KEY, NUM_SEMAPHORES, IPC_CREAT | 0666);
+// Create the POSIX shared memory object, named after the creating process
+// so concurrent and crashed runs never collide
+static int create_posix_shared_memory(size_t size, SimulationConfig config) {
+    shm_owner = getpid();
+    shm_map_flags = config.shm_prefault ? MAP_POPULATE : 0;
+    shm_advise_huge = false;
+    shm_populate_late = false;
     
-    if (sem_id == -1) {
-        perror("Failed to create semaphore set");
-        exit(1);
+    if (config.shm_huge_pages != SHM_HUGE_PAGES_NONE) {
+        size = (size + SHM_HUGE_PAGE_SIZE - 1) / SHM_HUGE_PAGE_SIZE * SHM_HUGE_PAGE_SIZE;
     }
+    shm_size = size;
     
-    // Initialize semaphores
-    union semun {
-        int val;
-        struct semid_ds* buf;
-        unsigned short* array;
-    } arg;
+    if (config.shm_huge_pages == SHM_HUGE_PAGES_EXPLICIT) {
+        int fd = create_huge_page_memfd(size);
+        if (fd != -1) {
+            shm_name[0] = '\0';
+            log_message("Shared memory backed by reserved huge pages");
+            return fd;
+        }
+        log_message("No reserved huge pages available; using transparent huge pages");
+    }
     
-    arg.val = 1;  // Binary semaphore
+    // Transparent huge pages only form once the range is advised, so in that
+    // case pre-faulting waits until after the madvise (see attach)
+    if (config.shm_huge_pages != SHM_HUGE_PAGES_NONE) {
+        shm_advise_huge = true;
+        shm_populate_late = config.shm_prefault;
+        shm_map_flags = 0;
+    }
     
-    if (semctl(sem_id, 0, SETVAL, arg) == -1) {
-        perror("Failed to initialize semaphore");
+    snprintf(shm_name, sizeof(shm_name), "/crime_sim-%d", (int)shm_owner);
+    int fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1 && errno == EEXIST) {
+        // Left behind by an earlier process with the same pid
+        shm_unlink(shm_name);
+        fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd == -1 || ftruncate(fd, size) == -1) {
+        perror("Failed to create shared memory");
         exit(1);
     }
+    return fd;
+}
+
+// Create shared memory segment sized for num_gangs gangs with the backend
+// chosen in the configuration. Either way the segment belongs to this run
+// alone. Returns the id to attach it with.
+int create_shared_memory(int num_gangs, SimulationConfig config) {
+    size_t size = shared_state_size(num_gangs);
+    shm_backend = config.shm_backend;
     
-    log_message("Created semaphore set with ID %d", sem_id);
-    return sem_id;
+    if (shm_backend == SHM_BACKEND_POSIX) {
+        shm_handle = create_posix_shared_memory(size, config);
+        log_message("Created shared memory object %s (%zu bytes, descriptor %d)",
+                    shm_name[0] != '\0' ? shm_name : "on huge pages", shm_size, shm_handle);
+        return shm_handle;
+    }
+    
+    shm_handle = create_sysv_shared_memory(size);
+    log_message("Created shared memory segment with ID %d", shm_handle);
+    return shm_handle;
 }
 
-// Destroy semaphore set
-void destroy_semaphore_set(int sem_id) {
-    if (semctl(sem_id, 0, IPC_RMID) == -1) {
-        perror("Failed to destroy semaphore set");
+// Id of the shared memory created earlier by this process or inherited from
+// its parent, or -1 if there is none
+int find_shared_memory(void) {
+    if (shm_handle == -1) {
+        log_message("No shared memory has been created for this run");
+    }
+    return shm_handle;
+}
+
+// Destroy shared memory segment
+void destroy_shared_memory(int shm_id) {
+    if (shm_backend == SHM_BACKEND_POSIX) {
+        // Forked processes inherit the name but only the creator unlinks it
+        if (getpid() != shm_owner) {
+            close(shm_id);
+            shm_handle = -1;
+            return;
+        }
+        if (shm_name[0] != '\0' && shm_unlink(shm_name) == -1) {
+            perror("Failed to destroy shared memory");
+        }
+        else {
+            log_message("Destroyed shared memory object with descriptor %d", shm_id);
+        }
+        close(shm_id);
+        shm_handle = -1;
+        shm_name[0] = '\0';
+        return;
+    }
+    
+    if (shmctl(shm_id, IPC_RMID, NULL) == -1) {
+        perror("Failed to destroy shared memory");
     }
     else {
-        log_message("Destroyed semaphore set with ID %d", sem_id);
+        log_message("Destroyed shared memory segment with ID %d", shm_id);
     }
 }
 
-// Wait on semaphore (P operation)
-void semaphore_wait(int sem_id, int sem_num) {
-    struct sembuf sb;
-    sb.sem_num = sem_num;
-    sb.sem_op = -1;
-    sb.sem_flg = 0;
+// Attach to shared memory
+SharedState* attach_shared_memory(int shm_id) {
+    if (shm_backend == SHM_BACKEND_POSIX) {
+        // The pages belong to the shared object, so pre-faulting them once
+        // in the creator is enough; forked attachers only map them
+        bool creator = getpid() == shm_owner;
+        int flags = MAP_SHARED | (creator ? shm_map_flags : 0);
+        void* mapping = mmap(NULL, shm_size, PROT_READ | PROT_WRITE, flags, shm_id, 0);
+        if (mapping == MAP_FAILED) {
+            perror("Failed to attach to shared memory");
+            exit(1);
+        }
+        
+        // Both are hints; the segment works the same without them. The huge
+        // page advice applies per mapping, so every attacher gives it.
+        if (shm_advise_huge) {
+            madvise(mapping, shm_size, MADV_HUGEPAGE);
+#ifdef MADV_POPULATE_WRITE
+            if (creator && shm_populate_late) {
+                madvise(mapping, shm_size, MADV_POPULATE_WRITE);
+            }
+#endif
+        }
+        return (SharedState*)mapping;
+    }
+    
+    SharedState* shm_ptr = (SharedState*)shmat(shm_id, NULL, 0);
     
-    if (semop(sem_id, &sb, 1) == -1) {
-        perror("Semaphore wait operation failed");
+    if (shm_ptr == (SharedState*)-1) {
+        perror("Failed to attach to shared memory");
+        exit(1);
     }
+    
+    return shm_ptr;
 }
 
-// Signal semaphore (V operation)
-void semaphore_signal(int sem_id, int sem_num) {
-    struct sembuf sb;
-    sb.sem_num = sem_num;
-    sb.sem_op = 1;
-    sb.sem_flg = 0;
+// Detach from shared memory
+void detach_shared_memory(SharedState* shm_ptr) {
+    if (shm_backend == SHM_BACKEND_POSIX) {
+        if (munmap(shm_ptr, shm_size) == -1) {
+            perror("Failed to detach from shared memory");
+        }
+        return;
+    }
     
-    if (semop(sem_id, &sb, 1) == -1) {
-        perror("Semaphore signal operation failed");
+    if (shmdt(shm_ptr) == -1) {
+        perror("Failed to detach from shared memory");
     }
 }
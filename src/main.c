@@ -4,7 +4,6 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/wait.h>
-#include <sys/msg.h>
 #include <errno.h>
 #include <pthread.h>
 #include "../include/config.h"
@@ -13,54 +12,51 @@
 #include "../include/ipc.h"
 #include "../include/utils.h"
 #include "../include/visualization.h"
+#include "../include/headless.h"
+#include "../include/sim_clock.h"
 
 // Global variables
 SimulationConfig config;
 VisualizationContext viz_context;
 SharedState* shared_state = NULL;
 int shm_id = -1;
-int sem_id = -1;
 int report_queue_id = -1;
 pid_t* gang_pids = NULL;
 pid_t police_pid = -1;
 
+// Pending runtime speed change requested by SIGUSR1 (+1, faster) or SIGUSR2 (-1, slower)
+volatile sig_atomic_t pending_speed_change = 0;
+
 // Function to handle cleanup on exit
 void cleanup() {
-    // Clean up IPC resources
+    // Clean up IPC resources. Handles are reset so a second call (signal
+    // handler, then exit path) does nothing.
     if (shared_state != NULL) {
         detach_shared_memory(shared_state);
+        shared_state = NULL;
+        viz_context.shared_state = NULL;
     }
     
     if (shm_id != -1) {
         destroy_shared_memory(shm_id);
-    }
-    
-    if (sem_id != -1) {
-        destroy_semaphore_set(sem_id);
+        shm_id = -1;
     }
     
     if (report_queue_id != -1) {
         destroy_report_queue(report_queue_id);
-    }
-    
-    // Clean up prep message queues
-    if (gang_pids != NULL) {
-        for (int i = 0; i < shared_state->num_gangs; i++) {
-            int prep_queue_id = msgget(REPORT_QUEUE_KEY + 1000 + i, 0666);
-            if (prep_queue_id != -1) {
-                msgctl(prep_queue_id, IPC_RMID, NULL);
-            }
-        }
+        report_queue_id = -1;
     }
     
     // Free allocated memory
     if (gang_pids != NULL) {
         free(gang_pids);
+        gang_pids = NULL;
     }
     
     // Free visualization resources
     if (viz_context.gang_states != NULL) {
         free(viz_context.gang_states);
+        viz_context.gang_states = NULL;
     }
     
     // Destroy mutex
@@ -75,12 +71,12 @@ void signal_handler(int sig) {
     
     // Update shared state to stop the simulation
     if (shared_state != NULL) {
-        shared_state->simulation_running = false;
+        end_simulation(shared_state);
     }
     
     // Kill all child processes if we're in the parent
     if (gang_pids != NULL) {
-        for (int i = 0; i < config.max_gangs; i++) {
+        for (int i = 0; i < shared_state->num_gangs; i++) {
             if (gang_pids[i] > 0) {
                 kill(gang_pids[i], SIGTERM);
             }
@@ -100,162 +96,53 @@ void signal_handler(int sig) {
     exit(0);
 }
 
+// Signal handler for runtime speed control
+void speed_signal_handler(int sig) {
+    pending_speed_change = (sig == SIGUSR1) ? 1 : -1;
+}
+
+// Apply a speed change requested through a signal, doubling or halving the clock
+void apply_pending_speed_change() {
+    int change = pending_speed_change;
+    if (change == 0) {
+        return;
+    }
+    pending_speed_change = 0;
+    
+    double time_scale = change > 0 ? sim_clock_get_scale() * 2.0 : sim_clock_get_scale() / 2.0;
+    sim_clock_set_scale(time_scale);
+    printf("Simulation speed set to %.3gx\n", sim_clock_get_scale());
+}
+
 // Gang process main function
 void run_gang_process(int gang_id, SimulationConfig config) {
     Gang gang;
     
-    // Initialize gang
-    int num_members = random_int(config.min_members_per_gang, config.max_members_per_gang);
-    initialize_gang(&gang, gang_id, num_members, config.gang_ranks, config);
-    
-    // Set report queue ID
-    gang.report_queue_id = report_queue_id;
+    // The gang's own random stream; members have their own in the gang
+    rng_seed_thread(gang_id, RNG_PROCESS_STREAM);
     
-    // Attach to shared memory
+    // Attach to shared memory; member ticks are timed by the shared clock
     SharedState* shm = attach_shared_memory(shm_id);
+    sim_clock_attach(&shm->clock);
+    
+    // Initialize gang
+    int num_members = random_int(config.min_members_per_gang, config.max_members_per_gang);
+    initialize_gang(&gang, gang_id, num_members, config.gang_ranks, shm->num_gangs,
+                    report_queue_id, config);
     
     // Plan initial mission
     plan_new_mission(&gang, config);
     
     // Track preparation time
-    int time_spent_preparing = 0;
-    bool mission_planned = true;
+    GangSchedule schedule;
+    schedule.time_spent_preparing = 0;
+    schedule.mission_planned = true;
     
     // Main gang loop
-    while (shm->simulation_running) {
-        // Check if termination conditions are met
-        if (shm->total_successful_missions >= config.max_successful_plans ||
-            shm->total_thwarted_missions >= config.max_thwarted_plans ||
-            shm->total_executed_agents >= config.max_executed_agents) {
-            break;
-        }
-        
-        // Check for arrest notification from police
-        semaphore_wait(sem_id, 0);
-        if (shm->gang_status[gang_id].is_arrested && !shm->gang_status[gang_id].arrest_notification_seen) {
-            // Gang has been arrested - process notification
-            gang.is_in_prison = true;
-            gang.prison_time_remaining = shm->gang_status[gang_id].prison_time;
-            shm->gang_status[gang_id].arrest_notification_seen = true;
-            
-            // Reset mission planning
-            time_spent_preparing = 0;
-            mission_planned = false;
-            
-            // Signal all gang member threads
-            pthread_mutex_lock(&gang.gang_mutex);
-            log_message("Gang %d has been arrested, %d members sent to prison for %d time units",
-                       gang_id, gang.num_members, gang.prison_time_remaining);
-            pthread_mutex_unlock(&gang.gang_mutex);
-        }
-        semaphore_signal(sem_id, 0);
-        
-        // Gang operations
-        if (!gang.is_in_prison) {
-            // Check if we're preparing or ready to execute
-            if (mission_planned) {
-                // Check if preparation time has elapsed
-                if (time_spent_preparing >= gang.preparation_time) {
-                    // Store previous mission counts to detect changes
-                    int prev_successful = gang.successful_missions;
-                    int prev_thwarted = gang.thwarted_missions;
-                    int prev_executed = gang.executed_agents;
-                    
-                    // Execute mission
-                    execute_mission(&gang, config);
-                    
-                    // Update shared memory based on mission outcome
-                    semaphore_wait(sem_id, 0);
-                    if (gang.successful_missions > prev_successful) {
-                        shm->total_successful_missions++;
-                        log_message("Gang %d mission succeeded - total successful missions: %d", 
-                                   gang_id, shm->total_successful_missions);
-                    }
-                    if (gang.thwarted_missions > prev_thwarted) {
-                        shm->total_thwarted_missions++;
-                        log_message("Gang %d mission failed - total thwarted missions: %d", 
-                                   gang_id, shm->total_thwarted_missions);
-                    }
-                    if (gang.executed_agents > prev_executed) {
-                        shm->total_executed_agents += (gang.executed_agents - prev_executed);
-                        log_message("Gang %d executed %d agents - total executed agents: %d", 
-                                   gang_id, (gang.executed_agents - prev_executed), shm->total_executed_agents);
-                    }
-                    semaphore_signal(sem_id, 0);
-                    
-                    // Plan next mission
-                    plan_new_mission(&gang, config);
-                    time_spent_preparing = 0;
-                } else {
-                    // Continue preparing
-                    time_spent_preparing++;
-                    
-                    // Log preparation status periodically
-                    if (time_spent_preparing % 2 == 0) {
-                        int total_prep = 0;
-                        int max_possible_prep = 0;
-                        pthread_mutex_lock(&gang.gang_mutex);
-                        for (int i = 0; i < gang.num_members; i++) {
-                            total_prep += gang.members[i].preparation_level;
-                            max_possible_prep += gang.required_preparation_level;
-                        }
-                        // Calculate as percentage of required level
-                        int avg_prep = max_possible_prep > 0 ? (total_prep * 100) / max_possible_prep : 0;
-                        pthread_mutex_unlock(&gang.gang_mutex);
-                        
-                        log_message("Gang %d preparing for %s: %d/%d time units, %d%% prepared", 
-                                   gang.id, crime_type_to_string(gang.current_target),
-                                   time_spent_preparing, gang.preparation_time, avg_prep);
-                        
-                        // Send preparation level to visualization through message queue
-                        int prep_queue_id = msgget(REPORT_QUEUE_KEY + 1000 + gang.id, IPC_CREAT | 0666);
-                        if (prep_queue_id != -1) {
-                            struct {
-                                long mtype;
-                                int preparation_level;
-                                CrimeType current_target;
-                                int num_members;
-                            } prep_msg;
-                            
-                            prep_msg.mtype = 2; // Message type 2 for preparation updates
-                            prep_msg.preparation_level = avg_prep;
-                            prep_msg.current_target = gang.current_target;
-                            prep_msg.num_members = gang.num_members;
-                            
-                            msgsnd(prep_queue_id, &prep_msg, sizeof(prep_msg) - sizeof(long), IPC_NOWAIT);
-                        }
-                    }
-                    
-                    // Sleep to simulate time passing and avoid busy waiting
-                    usleep(500000); // Sleep for 0.5 seconds
-                }
-            } else {
-                // Plan new mission if we don't have one
-                plan_new_mission(&gang, config);
-                time_spent_preparing = 0;
-                mission_planned = true;
-            }
-        }
-        else {
-            // Gang is in prison, decrease prison time
-            gang.prison_time_remaining--;
-            if (gang.prison_time_remaining <= 0) {
-                gang.is_in_prison = false;
-                
-                // Update shared memory to clear arrest status
-                semaphore_wait(sem_id, 0);
-                shm->gang_status[gang_id].is_arrested = false;
-                semaphore_signal(sem_id, 0);
-                
-                log_message("Gang %d has been released from prison", gang_id);
-                
-                // Signal all gang member threads to resume operations
-                pthread_mutex_lock(&gang.gang_mutex);
-                pthread_cond_broadcast(&gang.gang_cond);
-                pthread_mutex_unlock(&gang.gang_mutex);
-            }
-            sleep(1); // Sleep to avoid busy waiting
-        }
+    int delay;
+    while ((delay = gang_process_step(&gang, &schedule, shm, config)) != GANG_STEP_DONE) {
+        // Sleep to simulate time passing; the end of the simulation cuts it short
+        sim_clock_sleep_units_until(delay, &shm->ended);
     }
     
     // Cleanup
@@ -267,6 +154,7 @@ void run_gang_process(int gang_id, SimulationConfig config) {
 // Police process main function
 void run_police_process(SimulationConfig config) {
     Police police;
+    rng_seed_thread(RNG_POLICE_STREAM, 0);
     
     // Initialize police
     initialize_police(&police, config);
@@ -276,40 +164,23 @@ void run_police_process(SimulationConfig config) {
     
     // Attach to shared memory
     SharedState* shm = attach_shared_memory(shm_id);
+    sim_clock_attach(&shm->clock);
+    police.shared_state = shm;
     
     // Create police thread
     pthread_t police_thread;
     pthread_create(&police_thread, NULL, police_routine, &police);
     
-    // Main police loop
-    while (shm->simulation_running) {
-        // Check if termination conditions are met
-        if (shm->total_successful_missions >= config.max_successful_plans ||
-            shm->total_thwarted_missions >= config.max_thwarted_plans ||
-            shm->total_executed_agents >= config.max_executed_agents) {
-            break;
-        }
-        
+    // Main police loop. Waits for reports without spinning; end_simulation
+    // closes the report ring, which wakes the wait at once.
+    while (!simulation_has_ended(shm)) {
         // Process intelligence and take action
-        IntelligenceReport report;
-        if (receive_report(report_queue_id, &report) > 0) {
-            process_intelligence(&police, report, config);
-            
-            // Check if action should be taken
-            if (decide_on_action(&police, report.gang_id, config)) {
-                arrest_gang_members(&police, report.gang_id, config);
-                
-                // Update shared memory
-                semaphore_wait(sem_id, 0);
-                shm->total_thwarted_missions++;
-                semaphore_signal(sem_id, 0);
-            }
+        IntelligenceReport reports[POLICE_INTAKE_BATCH];
+        int received = receive_reports_timed(report_queue_id, reports, POLICE_INTAKE_BATCH,
+                                             POLICE_INTAKE_TIMEOUT_MS);
+        if (received > 0) {
+            police_handle_reports(&police, reports, received, config);
         }
-        
-        // Update shared memory with lost agents
-        semaphore_wait(sem_id, 0);
-        shm->total_executed_agents = police.lost_agents;
-        semaphore_signal(sem_id, 0);
     }
     
     // Wait for police thread to finish
@@ -371,16 +242,19 @@ void* visualization_thread_func(void* arg) {
                 
                 // Display simulation statistics
                 if (viz_context.shared_state != NULL) {
+                    SharedTotals totals = shared_totals(viz_context.shared_state);
                     printf("\nStatistics:\n");
                     printf("  Successful missions: %d / %d\n", 
-                        viz_context.shared_state->total_successful_missions,
+                        totals.successful_missions,
                         viz_context.config.max_successful_plans);
                     printf("  Thwarted missions: %d / %d\n", 
-                        viz_context.shared_state->total_thwarted_missions,
+                        totals.thwarted_missions,
                         viz_context.config.max_thwarted_plans);
                     printf("  Executed agents: %d / %d\n", 
-                        viz_context.shared_state->total_executed_agents,
+                        totals.executed_agents,
                         viz_context.config.max_executed_agents);
+                    printf("  Simulation time: %.1f time units (speed %.3gx)\n", 
+                        sim_clock_now_ms() / (double)SIM_TIME_UNIT_MS, sim_clock_get_scale());
                     printf("  Animation time: %.1f\n", 
                         viz_context.animation_time);
                 }
@@ -427,6 +301,26 @@ void* visualization_thread_func(void* arg) {
     return NULL;
 }
 
+// Refresh a gang's view from its shared slot. progress is the gang's
+// latest published progress, or NULL if it has not published yet.
+static void update_gang_view(GangVisState* view, GangSlot* slot, const GangProgress* progress) {
+    // An arrest order shows up before the gang has acted on it
+    view->is_in_prison = atomic_load(&slot->command.arrests) != atomic_load(&slot->status.arrests_seen);
+    view->prison_time_remaining = atomic_load(&slot->command.prison_time);
+    if (progress == NULL) {
+        return;
+    }
+    
+    view->is_in_prison = view->is_in_prison || progress->in_prison;
+    if (progress->in_prison) {
+        view->prison_time_remaining = progress->prison_time_remaining;
+    }
+    view->preparation_level = progress->preparation_level;
+    view->current_target = progress->current_target;
+    view->num_members = progress->num_members;
+    view->num_agents = progress->num_agents;
+}
+
 // Thread function for state updates
 void* gang_state_update_thread(void* arg) {
     int num_gangs = shared_state->num_gangs;
@@ -434,8 +328,10 @@ void* gang_state_update_thread(void* arg) {
     
     // Process update loop that runs alongside glutMainLoop
     while (1) {  // Keep running even if simulation ends
+        apply_pending_speed_change();
+        
         // Check if we've reached termination conditions
-        bool sim_running = shared_state->simulation_running;
+        bool sim_running = !simulation_has_ended(shared_state);
         
         // If simulation just ended, print a message
         if (sim_running == false && simulation_ended == false) {
@@ -445,40 +341,26 @@ void* gang_state_update_thread(void* arg) {
         
         // Update gang visualization states from shared memory
         for (int i = 0; i < num_gangs; i++) {
+            GangSlot* slot = shared_gang_slot(shared_state, i);
+            if (slot == NULL) {
+                continue;
+            }
+            
+            // Latest progress the gang published, if any yet
+            GangProgress progress;
+            bool published = read_gang_progress(&slot->status, &progress);
+            
             pthread_mutex_lock(&viz_context.mutex);
-            // Update arrest status
-            viz_context.gang_states[i].is_in_prison = shared_state->gang_status[i].is_arrested;
-            viz_context.gang_states[i].prison_time_remaining = shared_state->gang_status[i].prison_time;
+            update_gang_view(&viz_context.gang_states[i], slot, published ? &progress : NULL);
             pthread_mutex_unlock(&viz_context.mutex);
             
-            // Update preparation level - get this data through a message queue
-            int msg_queue_id = msgget(REPORT_QUEUE_KEY + 1000 + i, 0666);
-            if (msg_queue_id != -1) {
-                // Try to receive an update message without blocking
-                struct {
-                    long mtype;
-                    int preparation_level;
-                    CrimeType current_target;
-                    int num_members;
-                } prep_msg;
-                
-                if (msgrcv(msg_queue_id, &prep_msg, sizeof(prep_msg) - sizeof(long), 2, IPC_NOWAIT) != -1) {
-                    // Update visualization with thread safety
-                    pthread_mutex_lock(&viz_context.mutex);
-                    viz_context.gang_states[i].preparation_level = prep_msg.preparation_level;
-                    viz_context.gang_states[i].current_target = prep_msg.current_target;
-                    viz_context.gang_states[i].num_members = prep_msg.num_members;
-                    pthread_mutex_unlock(&viz_context.mutex);
-                    
-                    // Only print updates occasionally to avoid console spam
-                    static int update_count = 0;
-                    if (update_count++ % 10 == 0) {
-                        printf("Queue %d: Updated gang %d preparation: %d%%, target: %s, members: %d\n", 
-                               msg_queue_id, i, prep_msg.preparation_level, 
-                               crime_type_to_string(prep_msg.current_target), 
-                               prep_msg.num_members);
-                    }
-                }
+            // Only print updates occasionally to avoid console spam
+            static int update_count = 0;
+            if (published && update_count++ % 10 == 0) {
+                printf("Updated gang %d preparation: %d%%, target: %s, members: %d\n", 
+                       i, progress.preparation_level, 
+                       crime_type_to_string(progress.current_target), 
+                       progress.num_members);
             }
         }
         
@@ -510,43 +392,57 @@ void* gang_state_update_thread(void* arg) {
 
 int main(int argc, char* argv[]) {
     // Check command line arguments
-    if (argc < 2) {
-        printf("Usage: %s <config_file>\n", argv[0]);
+    bool headless = false;
+    bool verbose = false;
+    const char* config_file = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (config_file == NULL) {
+            config_file = argv[i];
+        }
+    }
+    
+    if (config_file == NULL) {
+        printf("Usage: %s [--headless [--verbose]] <config_file>\n", argv[0]);
         return 1;
     }
     
     // Load configuration
-    config = load_config(argv[1]);
+    config = load_config(config_file);
     print_config(config);
     
-    // Initialize random seed
-    srand(time(NULL));
+    // Initialize random seed; print it so the run can be reproduced with SEED=
+    unsigned long long seed = config.seed != 0 ? config.seed
+                            : ((unsigned long long)time(NULL) << 20) ^ (unsigned long long)getpid();
+    rng_set_seed(seed);
+    printf("Random seed: %llu\n", seed);
+    
+    // Headless mode runs the whole simulation in virtual time and exits
+    if (headless) {
+        HeadlessResult result = run_headless_simulation(config, verbose);
+        print_headless_result(result);
+        return 0;
+    }
     
     // Set up signal handlers
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
+    // Determine number of gangs; the shared segment is sized for them
+    int num_gangs = random_int(config.min_gangs, config.max_gangs);
+    
     // Initialize IPC mechanisms
-    shm_id = create_shared_memory();
+    shm_id = create_shared_memory(num_gangs, config);
     shared_state = attach_shared_memory(shm_id);
-    shared_state->simulation_running = true;
-    shared_state->total_successful_missions = 0;
-    shared_state->total_thwarted_missions = 0;
-    shared_state->total_executed_agents = 0;
-    
-    // Initialize gang status array
-    for (int i = 0; i < 100; i++) {
-        shared_state->gang_status[i].is_arrested = false;
-        shared_state->gang_status[i].prison_time = 0;
-        shared_state->gang_status[i].arrest_notification_seen = true;
-    }
+    init_shared_state(shared_state, num_gangs);
+    sim_clock_init(&shared_state->clock, config.time_scale);
+    sim_clock_attach(&shared_state->clock);
     
-    sem_id = create_semaphore_set();
     report_queue_id = create_report_queue();
     
-    // Determine number of gangs
-    int num_gangs = random_int(config.min_gangs, config.max_gangs);
-    shared_state->num_gangs = num_gangs;
     printf("Creating %d gangs for simulation.\n", num_gangs);
     
     // Allocate memory for gang PIDs
@@ -590,6 +486,10 @@ int main(int argc, char* argv[]) {
         exit(0);
     }
     
+    // Runtime speed control (parent only): kill -USR1 speeds up, -USR2 slows down
+    signal(SIGUSR1, speed_signal_handler);
+    signal(SIGUSR2, speed_signal_handler);
+    
     // Initialize visualization 
     printf("Initializing visualization...\n");
     
@@ -656,24 +556,6 @@ int main(int argc, char* argv[]) {
             viz_context.gang_states[i].is_active = true;
             
             printf("Initialized gang %d with %d members\n", i, viz_context.gang_states[i].num_members);
-            
-            // Create initial message queue for this gang
-            int prep_queue_id = msgget(REPORT_QUEUE_KEY + 1000 + i, IPC_CREAT | 0666);
-            if (prep_queue_id != -1) {
-                struct {
-                    long mtype;
-                    int preparation_level;
-                    CrimeType current_target;
-                    int num_members;
-                } prep_msg;
-                
-                prep_msg.mtype = 2; // Message type 2 for preparation updates
-                prep_msg.preparation_level = 0;
-                prep_msg.current_target = viz_context.gang_states[i].current_target;
-                prep_msg.num_members = viz_context.gang_states[i].num_members;
-                
-                msgsnd(prep_queue_id, &prep_msg, sizeof(prep_msg) - sizeof(long), IPC_NOWAIT);
-            }
         }
     }
     
@@ -703,7 +585,9 @@ int main(int argc, char* argv[]) {
         printf("GLUT main loop exited. Terminating simulation...\n");
     } else {
         // Text-only mode, run the normal monitoring loop
-        while (shared_state->simulation_running) {
+        while (true) {
+            apply_pending_speed_change();
+            
             // Check visualization thread health every few iterations
             pthread_mutex_lock(&viz_context.mutex);
             int current_health = viz_context.viz_thread_health;
@@ -750,81 +634,57 @@ int main(int argc, char* argv[]) {
             previous_health_count = current_health;
             
             // Check if termination conditions are met
-            if (shared_state->total_successful_missions >= config.max_successful_plans) {
+            SharedTotals totals = shared_totals(shared_state);
+            if (totals.successful_missions >= config.max_successful_plans) {
                 printf("Simulation ended: Gangs completed %d successful missions.\n", 
-                      shared_state->total_successful_missions);
+                      totals.successful_missions);
                 break;
             }
-            else if (shared_state->total_thwarted_missions >= config.max_thwarted_plans) {
+            else if (totals.thwarted_missions >= config.max_thwarted_plans) {
                 printf("Simulation ended: Police thwarted %d gang plans.\n", 
-                      shared_state->total_thwarted_missions);
+                      totals.thwarted_missions);
                 break;
             }
-            else if (shared_state->total_executed_agents >= config.max_executed_agents) {
+            else if (totals.executed_agents >= config.max_executed_agents) {
                 printf("Simulation ended: %d secret agents have been executed.\n", 
-                      shared_state->total_executed_agents);
+                      totals.executed_agents);
+                break;
+            }
+            else if (simulation_has_ended(shared_state)) {
                 break;
             }
             
             // Update gang visualization states from shared memory
             for (int i = 0; i < num_gangs; i++) {
-                // Update arrest status
-                viz_context.gang_states[i].is_in_prison = shared_state->gang_status[i].is_arrested;
-                viz_context.gang_states[i].prison_time_remaining = shared_state->gang_status[i].prison_time;
+                GangSlot* slot = shared_gang_slot(shared_state, i);
+                if (slot == NULL) {
+                    continue;
+                }
                 
-                // Update preparation level - get this data through a message queue
-                int msg_queue_id = msgget(REPORT_QUEUE_KEY + 1000 + i, 0666);
-                if (msg_queue_id != -1) {
-                    // Try to receive an update message without blocking
-                    struct {
-                        long mtype;
-                        int preparation_level;
-                        CrimeType current_target;
-                        int num_members;
-                    } prep_msg;
-                    
-                    if (msgrcv(msg_queue_id, &prep_msg, sizeof(prep_msg) - sizeof(long), 2, IPC_NOWAIT) != -1) {
-                        // Update visualization if we received a message
-                        viz_context.gang_states[i].preparation_level = prep_msg.preparation_level;
-                        viz_context.gang_states[i].current_target = prep_msg.current_target;
-                        viz_context.gang_states[i].num_members = prep_msg.num_members;
-                        
-                        // Only print updates occasionally to avoid console spam
-                        static int update_count = 0;
-                        if (update_count++ % 10 == 0) {
-                            printf("Queue %d: Updated gang %d preparation: %d%%, target: %s, members: %d\n", 
-                                   msg_queue_id, i, prep_msg.preparation_level, 
-                                   crime_type_to_string(prep_msg.current_target), 
-                                   prep_msg.num_members);
-                        }
-                    } else {
-                        // Debug message when no message is available (print less frequently)
-                        static int no_message_count = 0;
-                        if (no_message_count++ % 100 == 0) {  // Reduced frequency to every 100th failure
-                            printf("No message available for gang %d in queue %d (errno: %d)\n", 
-                                   i, msg_queue_id, errno);
-                        }
-                    }
-                } else {
-                    // Only print occasionally to avoid console spam
-                    static int queue_fail_count = 0;
-                    if (queue_fail_count++ % 200 == 0) {  // Reduced frequency to every 200th failure
-                        printf("Failed to get message queue for gang %d (key: %d, errno: %d)\n", 
-                               i, REPORT_QUEUE_KEY + 1000 + i, errno);
-                    }
+                GangProgress progress;
+                bool published = read_gang_progress(&slot->status, &progress);
+                update_gang_view(&viz_context.gang_states[i], slot, published ? &progress : NULL);
+                
+                // Only print updates occasionally to avoid console spam
+                static int update_count = 0;
+                if (published && update_count++ % 10 == 0) {
+                    printf("Updated gang %d preparation: %d%%, target: %s, members: %d\n", 
+                           i, progress.preparation_level, 
+                           crime_type_to_string(progress.current_target), 
+                           progress.num_members);
                 }
             }
             
             // Update animation time
             viz_context.animation_time += 0.1f;
             
-            // Sleep to avoid busy waiting
-            usleep(500000); // 0.5 seconds
+            // Wait half a second, or less if the simulation ends
+            wait_for_simulation_end(shared_state, 500);
         }
     }
     
     // Set the flag to indicate simulation is stopping
-    shared_state->simulation_running = false;
+    end_simulation(shared_state);
     
     // Signal all child processes to terminate
     signal_handler(SIGTERM);
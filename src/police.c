@@ -3,22 +3,211 @@
 #include <string.h>
 #include <unistd.h>
 #include <pthread.h>
+#include <math.h>
+#include <limits.h>
 #include "../include/police.h"
 #include "../include/utils.h"
 #include "../include/ipc.h"
 #include "../include/config.h"
+#include "../include/sim_clock.h"
+
+// Report chunks allocated at once when the pool runs dry
+#define REPORT_CHUNKS_PER_SLAB 16
+
+// Take a chunk of POLICE_REPORTS_PER_GANG reports from the pool
+static IntelligenceReport* report_pool_take(ReportPool* pool) {
+    if (pool->num_free == 0) {
+        if (pool->num_slabs == pool->slab_capacity) {
+            pool->slab_capacity = pool->slab_capacity > 0 ? pool->slab_capacity * 2 : 4;
+            pool->slabs = (void**)realloc(pool->slabs, pool->slab_capacity * sizeof(void*));
+            pool->free_chunks = (IntelligenceReport**)realloc(pool->free_chunks,
+                pool->slab_capacity * REPORT_CHUNKS_PER_SLAB * sizeof(IntelligenceReport*));
+            if (pool->slabs == NULL || pool->free_chunks == NULL) {
+                perror("Failed to grow police report pool");
+                exit(1);
+            }
+        }
+        
+        IntelligenceReport* slab = (IntelligenceReport*)malloc(
+            REPORT_CHUNKS_PER_SLAB * POLICE_REPORTS_PER_GANG * sizeof(IntelligenceReport));
+        if (slab == NULL) {
+            perror("Failed to allocate police reports");
+            exit(1);
+        }
+        pool->slabs[pool->num_slabs++] = slab;
+        for (int i = 0; i < REPORT_CHUNKS_PER_SLAB; i++) {
+            pool->free_chunks[pool->num_free++] = slab + i * POLICE_REPORTS_PER_GANG;
+        }
+    }
+    return pool->free_chunks[--pool->num_free];
+}
+
+// Give a chunk back to the pool
+static void report_pool_return(ReportPool* pool, IntelligenceReport* chunk) {
+    pool->free_chunks[pool->num_free++] = chunk;
+}
+
+// Reports kept for gang_id, or NULL if none were ever stored. With grow set,
+// the index is extended to cover gang_id. The caller holds police_mutex.
+static GangReports* gang_reports(Police* police, int gang_id, bool grow) {
+    if (gang_id < 0) {
+        return NULL;
+    }
+    if (gang_id >= police->gang_reports_capacity) {
+        if (!grow) {
+            return NULL;
+        }
+        int capacity = police->gang_reports_capacity > 0 ? police->gang_reports_capacity : 8;
+        while (capacity <= gang_id) {
+            capacity *= 2;
+        }
+        GangReports* grown = (GangReports*)realloc(police->gang_reports, capacity * sizeof(GangReports));
+        if (grown == NULL) {
+            perror("Failed to grow police report index");
+            exit(1);
+        }
+        memset(grown + police->gang_reports_capacity, 0,
+               (capacity - police->gang_reports_capacity) * sizeof(GangReports));
+        police->gang_reports = grown;
+        police->gang_reports_capacity = capacity;
+    }
+    return &police->gang_reports[gang_id];
+}
+
+// Current simulation time in ms
+static long long police_now_ms(const Police* police) {
+    return police->virtual_now_ms >= 0 ? police->virtual_now_ms : sim_clock_now_ms();
+}
+
+// Weight left after age_ms of decay
+static double evidence_decay(const Police* police, long long age_ms) {
+    if (police->half_life_ms <= 0 || age_ms <= 0) {
+        return 1.0;
+    }
+    return exp2(-(double)age_ms / police->half_life_ms);
+}
+
+// Age a gang's evidence to now_ms. Times never move backwards, so reports
+// that arrive late are weighted from the gang's evidence time instead.
+static void advance_evidence(const Police* police, GangReports* reports, long long now_ms) {
+    if (now_ms <= reports->evidence_time_ms) {
+        return;
+    }
+    double decay = evidence_decay(police, now_ms - reports->evidence_time_ms);
+    reports->weight *= decay;
+    reports->suspicion *= decay;
+    reports->reliable *= decay;
+    for (int i = 0; i < NUM_CRIME_TYPES; i++) {
+        reports->crime_weight[i] *= decay;
+    }
+    reports->evidence_time_ms = now_ms;
+}
+
+// Add (sign 1) or remove (sign -1) one report's current weight from its
+// gang's evidence
+static void account_report(const Police* police, GangReports* reports, const IntelligenceReport* report, int sign) {
+    double weight = sign * evidence_decay(police, reports->evidence_time_ms - report->time_ms);
+    reports->weight += weight;
+    reports->suspicion += weight * report->suspicion_level;
+    reports->reliable += weight * report->is_reliable;
+    reports->crime_weight[report->suspected_target] += weight;
+    reports->analysis_unlogged = true;
+}
+
+// Reset a gang's evidence to nothing
+static void clear_evidence(GangReports* reports) {
+    reports->weight = 0;
+    reports->suspicion = 0;
+    reports->reliable = 0;
+    memset(reports->crime_weight, 0, sizeof(reports->crime_weight));
+    reports->analysis_unlogged = true;
+}
+
+// Drop every report about one gang and return its chunk to the pool.
+// The caller holds police_mutex.
+static void release_gang_reports(Police* police, GangReports* reports) {
+    if (reports->items == NULL) {
+        return;
+    }
+    police->num_reports -= reports->count;
+    report_pool_return(&police->report_pool, reports->items);
+    reports->items = NULL;
+    reports->head = 0;
+    reports->count = 0;
+    clear_evidence(reports);
+}
+
+// Age a gang's evidence to now_ms and drop the reports that left the
+// evidence window, oldest first. The caller holds police_mutex.
+static void refresh_evidence(Police* police, GangReports* reports, long long now_ms) {
+    advance_evidence(police, reports, now_ms);
+    while (reports->count > 0 &&
+           now_ms - reports->items[reports->head].time_ms > police->window_ms) {
+        account_report(police, reports, &reports->items[reports->head], -1);
+        reports->head = (reports->head + 1) % POLICE_REPORTS_PER_GANG;
+        reports->count--;
+        police->num_reports--;
+    }
+    if (reports->count == 0) {
+        // Nothing left in the window; also drops rounding residue
+        release_gang_reports(police, reports);
+    }
+}
+
+// Store a report in its gang's ring, dropping the oldest when it is full.
+// The caller holds police_mutex.
+static void store_report(Police* police, IntelligenceReport report) {
+    GangReports* reports = gang_reports(police, report.gang_id, true);
+    if (reports == NULL) {
+        return;
+    }
+    
+    refresh_evidence(police, reports, police_now_ms(police));
+    if (reports->items == NULL) {
+        reports->items = report_pool_take(&police->report_pool);
+        reports->head = 0;
+        reports->count = 0;
+    }
+    if (reports->count == POLICE_REPORTS_PER_GANG) {
+        account_report(police, reports, &reports->items[reports->head], -1);
+        reports->head = (reports->head + 1) % POLICE_REPORTS_PER_GANG;
+        reports->count--;
+        police->num_reports--;
+    }
+    
+    reports->items[(reports->head + reports->count) % POLICE_REPORTS_PER_GANG] = report;
+    reports->count++;
+    account_report(police, reports, &report, 1);
+    reports->newest_seq = ++police->report_seq;
+    police->num_reports++;
+}
+
+// Decayed evidence rounded to whole reports
+static int evidence_count(double weight) {
+    return (int)lround(weight);
+}
 
 // Initialize police
 void initialize_police(Police* police, SimulationConfig config) {
     // Initialize report storage
-    police->report_capacity = 100;
-    police->reports = (IntelligenceReport*)malloc(police->report_capacity * sizeof(IntelligenceReport));
+    police->gang_reports = NULL;
+    police->gang_reports_capacity = 0;
     police->num_reports = 0;
+    police->report_seq = 0;
+    memset(&police->report_pool, 0, sizeof(police->report_pool));
+    police->half_life_ms = config.evidence_half_life * SIM_TIME_UNIT_MS;
+    police->window_ms = (long long)(EVIDENCE_WINDOW_HALF_LIVES * police->half_life_ms);
+    if (police->half_life_ms <= 0) {
+        police->window_ms = LLONG_MAX;
+    }
+    police->virtual_now_ms = -1;
     
     // Initialize statistics
     police->thwarted_missions = 0;
     police->total_agents = 0;
-    police->lost_agents = 0;
+    
+    // Shared state is attached by the owning process
+    police->shared_state = NULL;
     
     // Initialize synchronization
     pthread_mutex_init(&police->police_mutex, NULL);
@@ -27,10 +216,8 @@ void initialize_police(Police* police, SimulationConfig config) {
     log_message("Police force initialized");
 }
 
-// Process intelligence report
-void process_intelligence(Police* police, IntelligenceReport report, SimulationConfig config) {
-    pthread_mutex_lock(&police->police_mutex);
-    
+// Log and store one report. The caller holds police_mutex.
+static void intake_report(Police* police, IntelligenceReport report, SimulationConfig config) {
     // Log report receipt
     log_message("Police received intelligence from agent %d in gang %d (Suspicion: %d, Reliable: %s, Target: %s)",
                 report.agent_id, report.gang_id, report.suspicion_level,
@@ -38,16 +225,7 @@ void process_intelligence(Police* police, IntelligenceReport report, SimulationC
                 crime_type_to_string(report.suspected_target));
     
     // Store the report
-    if (police->num_reports < police->report_capacity) {
-        police->reports[police->num_reports++] = report;
-    }
-    else {
-        // Expand capacity if needed
-        police->report_capacity *= 2;
-        police->reports = (IntelligenceReport*)realloc(police->reports, 
-                                                      police->report_capacity * sizeof(IntelligenceReport));
-        police->reports[police->num_reports++] = report;
-    }
+    store_report(police, report);
     
     // Check if immediate action is needed for high-risk crimes
     if (report.suspicion_level > config.police_action_threshold && report.is_reliable) {
@@ -64,219 +242,259 @@ void process_intelligence(Police* police, IntelligenceReport report, SimulationC
                 break;
         }
     }
-    
-    pthread_mutex_unlock(&police->police_mutex);
 }
 
-// Decide whether to take action based on intelligence
-bool decide_on_action(Police* police, int gang_id, SimulationConfig config) {
+// Process intelligence report
+void process_intelligence(Police* police, IntelligenceReport report, SimulationConfig config) {
     pthread_mutex_lock(&police->police_mutex);
-    
-    int total_suspicion = 0;
-    int num_reports_for_gang = 0;
-    int num_reliable_reports = 0;
-    CrimeType suspected_crimes[7] = {0}; // Tracking different crime types reported
-    
-    // Analyze reports for the specified gang
-    for (int i = 0; i < police->num_reports; i++) {
-        if (police->reports[i].gang_id == gang_id) {
-            total_suspicion += police->reports[i].suspicion_level;
-            num_reports_for_gang++;
-            
-            // Track crime types reported
-            suspected_crimes[police->reports[i].suspected_target]++;
-            
-            if (police->reports[i].is_reliable) {
-                num_reliable_reports++;
-            }
-        }
+    intake_report(police, report, config);
+    pthread_mutex_unlock(&police->police_mutex);
+}
+
+// Decide whether to take action based on intelligence. Works from the
+// gang's decayed evidence, so recent reports count most; the report counts
+// below are that evidence rounded to whole reports.
+// The caller holds police_mutex.
+static bool evaluate_gang(Police* police, int gang_id, SimulationConfig config) {
+    GangReports* reports = gang_reports(police, gang_id, false);
+    if (reports != NULL) {
+        refresh_evidence(police, reports, police_now_ms(police));
     }
-    
-    // Calculate average suspicion level
-    int avg_suspicion = 0;
-    if (num_reports_for_gang > 0) {
-        avg_suspicion = total_suspicion / num_reports_for_gang;
+    if (reports == NULL || reports->count == 0) {
+        return false;
     }
     
-    // Find most reported crime type
-    int max_reports = 0;
-    CrimeType most_likely_crime = BANK_ROBBERY; // Default
-    for (int i = 0; i < NUM_CRIME_TYPES; i++) {
-        if (suspected_crimes[i] > max_reports) {
-            max_reports = suspected_crimes[i];
-            most_likely_crime = (CrimeType)i;
-        }
-    }
+    int num_reports_for_gang = evidence_count(reports->weight);
+    int num_reliable_reports = evidence_count(reports->reliable);
+    
+    // Calculate average suspicion level, weighted towards recent reports
+    int avg_suspicion = (int)(reports->suspicion / reports->weight);
     
     // Decision logic: take action if average suspicion is above threshold
     // and there is at least one reliable report, OR if suspicion is very high (>= 95)
     bool decision = (avg_suspicion >= config.police_action_threshold && num_reliable_reports > 0) ||
-                   (avg_suspicion >= 95 && num_reports_for_gang >= 3);
+                    (avg_suspicion >= 95 && num_reports_for_gang >= 3);
     
-    // Add debug logging to understand why decisions aren't being made
-    if (num_reports_for_gang > 0) {
+    // Add debug logging to understand why decisions aren't being made,
+    // once per change to the gang's reports
+    if (reports->analysis_unlogged) {
+        reports->analysis_unlogged = false;
         log_message("Police analysis for gang %d: %d reports, avg suspicion %d, reliable reports %d, threshold %d",
                     gang_id, num_reports_for_gang, avg_suspicion, num_reliable_reports, config.police_action_threshold);
     }
     
     if (decision) {
+        // Find most reported crime type
+        double max_weight = 0;
+        CrimeType most_likely_crime = BANK_ROBBERY; // Default
+        for (int i = 0; i < NUM_CRIME_TYPES; i++) {
+            if (reports->crime_weight[i] > max_weight) {
+                max_weight = reports->crime_weight[i];
+                most_likely_crime = (CrimeType)i;
+            }
+        }
+        
         log_message("Police decided to take action against gang %d (Avg suspicion: %d, Reliable reports: %d, Suspected crime: %s)",
                     gang_id, avg_suspicion, num_reliable_reports, crime_type_to_string(most_likely_crime));
     }
     
+    return decision;
+}
+
+// Decide whether to take action against a gang (see evaluate_gang)
+bool decide_on_action(Police* police, int gang_id, SimulationConfig config) {
+    pthread_mutex_lock(&police->police_mutex);
+    bool decision = evaluate_gang(police, gang_id, config);
     pthread_mutex_unlock(&police->police_mutex);
-    
     return decision;
 }
 
+// Resolve the shared state used by the police. Processes that did not
+// attach one up front look it up by key; *attached_here tells the caller to
+// detach when done.
+static SharedState* police_shared_state(Police* police, bool* attached_here) {
+    *attached_here = false;
+    if (police->shared_state != NULL) {
+        return police->shared_state;
+    }
+    
+    int shm_id = find_shared_memory();
+    if (shm_id == -1) {
+        return NULL;
+    }
+    
+    *attached_here = true;
+    return attach_shared_memory(shm_id);
+}
+
 // Arrest gang members
 void arrest_gang_members(Police* police, int gang_id, SimulationConfig config) {
     // Get shared memory to communicate with the gang process
-    int shm_id = shmget(SHARED_MEMORY_KEY, 0, 0);
-    if (shm_id == -1) {
-        perror("Failed to find shared memory for arrest");
+    bool attached_here;
+    SharedState* shm = police_shared_state(police, &attached_here);
+    if (shm == NULL) {
         return;
     }
     
-    SharedState* shm = attach_shared_memory(shm_id);
-    
     // Set the gang's prison time - random value between min and max from config
     int prison_time = random_int(config.prison_time_min, config.prison_time_max);
     
-    // Get the semaphore ID - try to find it the same way we found the shared memory
-    int sem_id = -1;
-    for (int i = 0; i < 100; i++) {  // Try some IDs to find the semaphore
-        sem_id = semget(SEMAPHORE_KEY, 0, 0);
-        if (sem_id != -1) break;
-    }
-    
-    if (sem_id == -1) {
-        perror("Failed to find semaphore for arrest");
-        detach_shared_memory(shm);
-        return;
-    }
-    
-    // Update the gang status in shared memory
-    semaphore_wait(sem_id, 0);  // Get exclusive access
-    
-    if (gang_id < shm->num_gangs) {
-        // Set arrest status
-        shm->gang_status[gang_id].is_arrested = true;
-        shm->gang_status[gang_id].prison_time = prison_time;
-        shm->gang_status[gang_id].arrest_notification_seen = false;
+    // Order the arrest through the gang's command line in shared memory.
+    // The release publishes prison_time along with the new arrest count.
+    GangSlot* slot = shared_gang_slot(shm, gang_id);
+    if (slot != NULL) {
+        atomic_store_explicit(&slot->command.prison_time, prison_time, memory_order_relaxed);
+        atomic_fetch_add_explicit(&slot->command.arrests, 1, memory_order_release);
         
         log_message("Police arrested members of gang %d for %d time units", gang_id, prison_time);
     }
     
-    semaphore_signal(sem_id, 0);  // Release exclusive access
-    
     // Update statistics
     pthread_mutex_lock(&police->police_mutex);
     police->thwarted_missions++;
     pthread_mutex_unlock(&police->police_mutex);
     
     // Detach from shared memory
-    detach_shared_memory(shm);
+    if (attached_here) {
+        detach_shared_memory(shm);
+    }
 }
 
-// Police routine (background thread)
-void* police_routine(void* arg) {
-    Police* police = (Police*)arg;
+// Arrest a gang and count the thwarted mission in shared memory, ending the
+// simulation if that reaches the limit. The thwart is claimed first, so no
+// arrest is made once the limit has been claimed or the simulation is over.
+static void thwart_gang_mission(Police* police, int gang_id, SimulationConfig config) {
+    bool attached_here;
+    SharedState* shm = police_shared_state(police, &attached_here);
+    if (shm == NULL) {
+        return;
+    }
     
-    // Get configuration for decision making
-    SimulationConfig config = load_config("config/simulation_config.txt");
+    if (claim_outcomes(shm, &shm->claims.thwarted_missions, 1, config.max_thwarted_plans) > 0) {
+        arrest_gang_members(police, gang_id, config);
+        atomic_fetch_add(&shm->police.thwarted_missions, 1);
+        check_simulation_limits(shm, config);
+    }
     
-    // Main police monitoring loop
-    while (1) {
-        int max_gang_id = -1;
-        int max_reports = 0;
-        bool should_take_action = false;
+    if (attached_here) {
+        detach_shared_memory(shm);
+    }
+}
+
+// Remove all stored reports about one gang
+static void clear_reports_for_gang(Police* police, int gang_id) {
+    pthread_mutex_lock(&police->police_mutex);
+    GangReports* reports = gang_reports(police, gang_id, false);
+    if (reports != NULL) {
+        release_gang_reports(police, reports);
+    }
+    pthread_mutex_unlock(&police->police_mutex);
+}
+
+// Handle a single incoming report: store it, then arrest the gang if warranted
+void police_handle_report(Police* police, IntelligenceReport report, SimulationConfig config) {
+    police_handle_reports(police, &report, 1, config);
+}
+
+// Handle a batch of incoming reports: store them all under one lock, then
+// evaluate each gang they mention once, in order of first mention, and
+// arrest the gangs that warrant it. Arrests run after the lock is released.
+void police_handle_reports(Police* police, const IntelligenceReport* reports, int num_reports, SimulationConfig config) {
+    for (int start = 0; start < num_reports; start += POLICE_INTAKE_BATCH) {
+        int end = start + POLICE_INTAKE_BATCH < num_reports ? start + POLICE_INTAKE_BATCH : num_reports;
+        int touched[POLICE_INTAKE_BATCH];
+        int num_touched = 0;
         
-        // Analyze all reports to identify patterns (with proper mutex handling)
         pthread_mutex_lock(&police->police_mutex);
-        {
-            int reports_by_gang[100] = {0};  // Count reports by gang ID (assumes max 100 gangs)
+        for (int i = start; i < end; i++) {
+            intake_report(police, reports[i], config);
             
-            for (int i = 0; i < police->num_reports; i++) {
-                int gang_id = police->reports[i].gang_id;
-                reports_by_gang[gang_id]++;
-                
-                if (reports_by_gang[gang_id] > max_reports) {
-                    max_reports = reports_by_gang[gang_id];
-                    max_gang_id = gang_id;
-                }
+            GangReports* gang = gang_reports(police, reports[i].gang_id, false);
+            if (gang != NULL && !gang->pending_decision) {
+                gang->pending_decision = true;
+                touched[num_touched++] = reports[i].gang_id;
             }
         }
-        pthread_mutex_unlock(&police->police_mutex);
         
-        // Log police activity periodically
-        if (max_gang_id >= 0 && max_reports > 2) {
-            log_message("Police monitoring gang %d closely (%d reports received)", 
-                       max_gang_id, max_reports);
-            
-            // Check if we should take action against the most reported gang
-            should_take_action = decide_on_action(police, max_gang_id, config);
-            
-            if (should_take_action) {
-                log_message("Police routine decided to take proactive action against gang %d", max_gang_id);
-                arrest_gang_members(police, max_gang_id, config);
-                
-                // Update shared memory
-                int shm_id = shmget(SHARED_MEMORY_KEY, 0, 0);
-                if (shm_id != -1) {
-                    SharedState* shm = attach_shared_memory(shm_id);
-                    int sem_id = semget(SEMAPHORE_KEY, 0, 0);
-                    if (sem_id != -1) {
-                        semaphore_wait(sem_id, 0);
-                        shm->total_thwarted_missions++;
-                        semaphore_signal(sem_id, 0);
-                    }
-                    detach_shared_memory(shm);
-                }
-                
-                // Clear reports for this gang after successful arrest
-                pthread_mutex_lock(&police->police_mutex);
-                int new_report_count = 0;
-                for (int i = 0; i < police->num_reports; i++) {
-                    if (police->reports[i].gang_id != max_gang_id) {
-                        police->reports[new_report_count++] = police->reports[i];
-                    }
-                }
-                police->num_reports = new_report_count;
-                pthread_mutex_unlock(&police->police_mutex);
-            } else {
-                // If no action taken but we have many reports, clear old reports to prevent infinite loop
-                // Clear reports for gangs that have been analyzed multiple times without action
-                if (max_reports >= 5) {
-                    log_message("Police clearing stale reports for gang %d (insufficient evidence for action)", max_gang_id);
-                    pthread_mutex_lock(&police->police_mutex);
-                    int new_report_count = 0;
-                    for (int i = 0; i < police->num_reports; i++) {
-                        if (police->reports[i].gang_id != max_gang_id) {
-                            police->reports[new_report_count++] = police->reports[i];
-                        }
-                    }
-                    police->num_reports = new_report_count;
-                    pthread_mutex_unlock(&police->police_mutex);
-                }
+        int arrests[POLICE_INTAKE_BATCH];
+        int num_arrests = 0;
+        for (int i = 0; i < num_touched; i++) {
+            police->gang_reports[touched[i]].pending_decision = false;
+            if (evaluate_gang(police, touched[i], config)) {
+                arrests[num_arrests++] = touched[i];
             }
         }
+        pthread_mutex_unlock(&police->police_mutex);
         
-        // Periodic cleanup: clear all reports every 30 iterations to prevent infinite accumulation
-        static int cleanup_counter = 0;
-        cleanup_counter++;
-        if (cleanup_counter >= 30) {
-            cleanup_counter = 0;
-            pthread_mutex_lock(&police->police_mutex);
-            if (police->num_reports > 10) {
-                log_message("Police performing periodic cleanup of %d stale reports", police->num_reports);
-                police->num_reports = 0; // Clear all reports periodically
-            }
-            pthread_mutex_unlock(&police->police_mutex);
+        for (int i = 0; i < num_arrests; i++) {
+            thwart_gang_mission(police, arrests[i], config);
+        }
+    }
+}
+
+// One monitoring pass over the accumulated reports
+void police_routine_step(Police* police, SimulationConfig config) {
+    int max_gang_id = -1;
+    int max_reports = 0;
+    bool should_take_action = false;
+    
+    // Find the gang with the most evidence; among equals, the one whose
+    // newest report arrived first. Aging the evidence here also lets old
+    // reports leave the window even for gangs that stopped reporting.
+    pthread_mutex_lock(&police->police_mutex);
+    long long now_ms = police_now_ms(police);
+    double max_weight = 0;
+    unsigned long max_newest_seq = 0;
+    for (int gang_id = 0; gang_id < police->gang_reports_capacity; gang_id++) {
+        GangReports* reports = &police->gang_reports[gang_id];
+        if (reports->count == 0) {
+            continue;
         }
+        refresh_evidence(police, reports, now_ms);
+        if (reports->count > 0 &&
+            (reports->weight > max_weight ||
+             (reports->weight == max_weight && reports->newest_seq < max_newest_seq))) {
+            max_weight = reports->weight;
+            max_gang_id = gang_id;
+            max_newest_seq = reports->newest_seq;
+        }
+    }
+    max_reports = evidence_count(max_weight);
+    pthread_mutex_unlock(&police->police_mutex);
+    
+    // Log police activity periodically
+    if (max_gang_id >= 0 && max_reports > 2) {
+        log_message("Police monitoring gang %d closely (%d reports received)", 
+                   max_gang_id, max_reports);
+        
+        // Check if we should take action against the most reported gang
+        should_take_action = decide_on_action(police, max_gang_id, config);
         
-        // Sleep to avoid busy waiting
-        sleep(2);
+        if (should_take_action) {
+            log_message("Police routine decided to take proactive action against gang %d", max_gang_id);
+            thwart_gang_mission(police, max_gang_id, config);
+            
+            // Clear reports for this gang after successful arrest
+            clear_reports_for_gang(police, max_gang_id);
+        }
+    }
+}
+
+// Police routine (background thread)
+void* police_routine(void* arg) {
+    Police* police = (Police*)arg;
+    rng_seed_thread(RNG_POLICE_STREAM, 1);
+    
+    // Get configuration for decision making
+    SimulationConfig config = load_config("config/simulation_config.txt");
+    
+    // Main police monitoring loop, until the simulation ends
+    SharedState* shm = police->shared_state;
+    while (shm == NULL || !simulation_has_ended(shm)) {
+        police_routine_step(police, config);
+        
+        // Sleep to avoid busy waiting; the end of the simulation cuts it short
+        sim_clock_sleep_units_until(POLICE_ANALYSIS_UNITS, shm != NULL ? &shm->ended : NULL);
     }
     
     return NULL;
@@ -289,7 +507,12 @@ void cleanup_police(Police* police) {
     pthread_cond_destroy(&police->police_cond);
     
     // Free allocated memory
-    free(police->reports);
+    free(police->gang_reports);
+    for (int i = 0; i < police->report_pool.num_slabs; i++) {
+        free(police->report_pool.slabs[i]);
+    }
+    free(police->report_pool.slabs);
+    free(police->report_pool.free_chunks);
     
     log_message("Police resources cleaned up");
 }
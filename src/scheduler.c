@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../include/scheduler.h"
+
+// Whether event a must run before event b
+static bool event_before(const SimEvent* a, const SimEvent* b) {
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+    return a->seq < b->seq;
+}
+
+// Initialize an empty event queue
+void event_queue_init(EventQueue* queue, int capacity) {
+    if (capacity < 16) {
+        capacity = 16;
+    }
+    
+    queue->events = (SimEvent*)malloc(capacity * sizeof(SimEvent));
+    if (queue->events == NULL) {
+        perror("Failed to allocate event queue");
+        exit(1);
+    }
+    
+    queue->size = 0;
+    queue->capacity = capacity;
+    queue->next_seq = 0;
+}
+
+// Schedule an event at the given virtual time
+void event_queue_push(EventQueue* queue, long long time, EventType type, int gang_id, int member_id) {
+    // Expand capacity if needed
+    if (queue->size == queue->capacity) {
+        queue->capacity *= 2;
+        queue->events = (SimEvent*)realloc(queue->events, queue->capacity * sizeof(SimEvent));
+        if (queue->events == NULL) {
+            perror("Failed to grow event queue");
+            exit(1);
+        }
+    }
+    
+    SimEvent event;
+    event.time = time;
+    event.seq = queue->next_seq++;
+    event.type = type;
+    event.gang_id = gang_id;
+    event.member_id = member_id;
+    
+    // Sift up
+    int i = queue->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!event_before(&event, &queue->events[parent])) {
+            break;
+        }
+        queue->events[i] = queue->events[parent];
+        i = parent;
+    }
+    queue->events[i] = event;
+}
+
+// Remove the earliest event; returns false when the queue is empty
+bool event_queue_pop(EventQueue* queue, SimEvent* event) {
+    if (queue->size == 0) {
+        return false;
+    }
+    
+    *event = queue->events[0];
+    SimEvent last = queue->events[--queue->size];
+    
+    // Sift down
+    int i = 0;
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= queue->size) {
+            break;
+        }
+        if (child + 1 < queue->size && event_before(&queue->events[child + 1], &queue->events[child])) {
+            child++;
+        }
+        if (!event_before(&queue->events[child], &last)) {
+            break;
+        }
+        queue->events[i] = queue->events[child];
+        i = child;
+    }
+    queue->events[i] = last;
+    
+    return true;
+}
+
+// Copy the earliest event without removing it; returns false when the queue is empty
+bool event_queue_peek(const EventQueue* queue, SimEvent* event) {
+    if (queue->size == 0) {
+        return false;
+    }
+    *event = queue->events[0];
+    return true;
+}
+
+// Whether any events remain
+bool event_queue_empty(const EventQueue* queue) {
+    return queue->size == 0;
+}
+
+// Free event queue storage
+void event_queue_destroy(EventQueue* queue) {
+    free(queue->events);
+    queue->events = NULL;
+    queue->size = 0;
+    queue->capacity = 0;
+}
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../include/sim_clock.h"
+#include "../include/utils.h"
+
+// Clock used by this process; NULL until sim_clock_attach is called, in
+// which case simulated time runs at 1x from process start
+static SimClock* process_clock = NULL;
+
+// Read the monotonic clock in ns
+static long long monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Clamp a requested time scale to the supported range
+static double clamp_scale(double time_scale) {
+    if (time_scale < SIM_CLOCK_MIN_SCALE) return SIM_CLOCK_MIN_SCALE;
+    if (time_scale > SIM_CLOCK_MAX_SCALE) return SIM_CLOCK_MAX_SCALE;
+    return time_scale;
+}
+
+// Take a consistent copy of the clock's anchor and scale
+static void read_anchor(SimClock* clock, long long* wall_ns, long long* sim_ns, double* time_scale) {
+    unsigned int seq;
+    do {
+        seq = atomic_load_explicit(&clock->sequence, memory_order_acquire);
+        if (seq & 1) {
+            continue;
+        }
+        *wall_ns = atomic_load_explicit(&clock->anchor_wall_ns, memory_order_relaxed);
+        *sim_ns = atomic_load_explicit(&clock->anchor_sim_ns, memory_order_relaxed);
+        *time_scale = atomic_load_explicit(&clock->time_scale, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+    } while ((seq & 1) || atomic_load_explicit(&clock->sequence, memory_order_relaxed) != seq);
+}
+
+// Simulated time in ns according to the given clock
+static long long clock_now_ns(SimClock* clock) {
+    long long wall_ns, sim_ns;
+    double time_scale;
+    read_anchor(clock, &wall_ns, &sim_ns, &time_scale);
+    return sim_ns + (long long)((monotonic_ns() - wall_ns) * time_scale);
+}
+
+// Initialize a clock at simulated time zero (done once by the parent process)
+void sim_clock_init(SimClock* clock, double time_scale) {
+    atomic_init(&clock->sequence, 0);
+    atomic_init(&clock->time_scale, clamp_scale(time_scale));
+    atomic_init(&clock->anchor_wall_ns, monotonic_ns());
+    atomic_init(&clock->anchor_sim_ns, 0);
+}
+
+// Use the given (shared) clock for all sim_clock_* calls in this process
+void sim_clock_attach(SimClock* clock) {
+    process_clock = clock;
+}
+
+// Current simulated time in ms
+long long sim_clock_now_ms(void) {
+    if (process_clock == NULL) {
+        return 0;
+    }
+    return clock_now_ns(process_clock) / 1000000LL;
+}
+
+// Current time scale
+double sim_clock_get_scale(void) {
+    if (process_clock == NULL) {
+        return 1.0;
+    }
+    return atomic_load_explicit(&process_clock->time_scale, memory_order_relaxed);
+}
+
+// Change the time scale at runtime; every process sees the new speed on its
+// next clock read
+void sim_clock_set_scale(double time_scale) {
+    SimClock* clock = process_clock;
+    if (clock == NULL) {
+        return;
+    }
+    
+    // Acquire the writer side by moving the sequence from even to odd
+    unsigned int seq = atomic_load_explicit(&clock->sequence, memory_order_relaxed);
+    do {
+        seq &= ~1u;
+    } while (!atomic_compare_exchange_weak_explicit(&clock->sequence, &seq, seq + 1,
+                                                    memory_order_acquire, memory_order_relaxed));
+    
+    // Re-anchor so simulated time is continuous across the change
+    long long now_wall = monotonic_ns();
+    long long wall_ns = atomic_load_explicit(&clock->anchor_wall_ns, memory_order_relaxed);
+    long long sim_ns = atomic_load_explicit(&clock->anchor_sim_ns, memory_order_relaxed);
+    double old_scale = atomic_load_explicit(&clock->time_scale, memory_order_relaxed);
+    
+    atomic_store_explicit(&clock->anchor_sim_ns, sim_ns + (long long)((now_wall - wall_ns) * old_scale),
+                          memory_order_relaxed);
+    atomic_store_explicit(&clock->anchor_wall_ns, now_wall, memory_order_relaxed);
+    atomic_store_explicit(&clock->time_scale, clamp_scale(time_scale), memory_order_relaxed);
+    
+    atomic_store_explicit(&clock->sequence, seq + 2, memory_order_release);
+}
+
+// Sleep for wall_ms, or until stop becomes nonzero if it is given
+static void pause_ms(long long wall_ms, atomic_uint* stop) {
+    if (stop == NULL) {
+        delay_ms((int)wall_ms);
+        return;
+    }
+    
+    struct timespec timeout;
+    timeout.tv_sec = wall_ms / 1000;
+    timeout.tv_nsec = (wall_ms % 1000) * 1000000L;
+    futex_wait(stop, 0, &timeout);
+}
+
+// Sleep for the given number of simulation time units at the current speed.
+// Long sleeps are split so a runtime speed change applies mid-sleep.
+void sim_clock_sleep_units(int units) {
+    sim_clock_sleep_units_until(units, NULL);
+}
+
+// Like sim_clock_sleep_units, but return as soon as the futex word stop
+// (if not NULL) becomes nonzero and is woken
+void sim_clock_sleep_units_until(int units, atomic_uint* stop) {
+    if (units <= 0) {
+        return;
+    }
+    
+    if (process_clock == NULL) {
+        pause_ms((long long)units * SIM_TIME_UNIT_MS, stop);
+        return;
+    }
+    
+    long long target_ns = clock_now_ns(process_clock) + (long long)units * SIM_TIME_UNIT_MS * 1000000LL;
+    while (stop == NULL || atomic_load_explicit(stop, memory_order_acquire) == 0) {
+        long long remaining_ns = target_ns - clock_now_ns(process_clock);
+        if (remaining_ns <= 0) {
+            break;
+        }
+        
+        double time_scale = sim_clock_get_scale();
+        long long wall_ms = (long long)(remaining_ns / time_scale / 1000000.0) + 1;
+        if (wall_ms > SIM_CLOCK_MAX_SLEEP_MS) {
+            wall_ms = SIM_CLOCK_MAX_SLEEP_MS;
+        }
+        pause_ms(wall_ms, stop);
+    }
+}
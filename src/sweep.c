@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/sweep.h"
+#include "../include/batch.h"
+#include "../include/worker_pool.h"
+
+// Result of one sweep point, sent from a worker to the parent
+typedef struct {
+    double values[SWEEP_MAX_AXES];
+    BatchSummary summary;
+} SweepPointResult;
+
+// State shared by the sweep callbacks
+typedef struct {
+    SimulationConfig base;
+    const SweepSpec* spec;
+    SweepOptions options;
+    long long num_points;
+    long long completed;
+} SweepContext;
+
+// Worker side: run every simulation of one point
+static void sweep_task(long long index, void* result, void* ctx) {
+    SweepContext* sweep = (SweepContext*)ctx;
+    SweepPointResult* point = (SweepPointResult*)result;
+    
+    sweep_point_values(sweep->spec, index, sweep->options.base_seed, point->values);
+    SimulationConfig config = sweep_point_config(sweep->base, sweep->spec, point->values);
+    
+    batch_summary_init(&point->summary);
+    int runs = sweep->spec->runs_per_point;
+    for (int r = 0; r < runs; r++) {
+        HeadlessResult run;
+        run_seeded_simulation(config, sweep->options.base_seed + (uint64_t)(index * runs + r), &run);
+        batch_summary_add(&point->summary, run);
+    }
+}
+
+// Parent side: write one CSV row per finished point
+static bool sweep_result(long long index, const void* result, void* ctx) {
+    SweepContext* sweep = (SweepContext*)ctx;
+    const SweepPointResult* point = (const SweepPointResult*)result;
+    const BatchSummary* summary = &point->summary;
+    FILE* out = sweep->options.output;
+    
+    fprintf(out, "%lld", index);
+    for (int i = 0; i < sweep->spec->num_axes; i++) {
+        fprintf(out, ",%g", point->values[i]);
+    }
+    fprintf(out, ",%lld", summary->runs);
+    for (int i = 0; i < NUM_OUTCOMES; i++) {
+        fprintf(out, ",%.6f", summary->runs > 0 ? (double)summary->outcome_counts[i] / summary->runs : 0.0);
+    }
+    fprintf(out, ",%.3f,%.3f,%.3f,%.3f,%.4f\n", summary->time_units.mean,
+            summary->successful_missions.mean, summary->thwarted_missions.mean,
+            summary->executed_agents.mean, summary->agent_survival.mean);
+    
+    sweep->completed++;
+    if (sweep->options.show_progress && sweep->completed % 1000 == 0) {
+        fprintf(stderr, "%lld/%lld points\n", sweep->completed, sweep->num_points);
+    }
+    return true;
+}
+
+// Run every point of a sweep on a pool of worker processes, writing CSV rows
+// in completion order. Returns the number of points written.
+long long run_sweep(SimulationConfig base, const SweepSpec* spec, SweepOptions options) {
+    SweepContext sweep;
+    sweep.base = base;
+    sweep.spec = spec;
+    sweep.options = options;
+    sweep.num_points = sweep_num_points(spec);
+    sweep.completed = 0;
+    
+    // Header
+    FILE* out = options.output;
+    fprintf(out, "point");
+    for (int i = 0; i < spec->num_axes; i++) {
+        fprintf(out, ",%s", spec->axes[i].key);
+    }
+    fprintf(out, ",runs,p_gangs_win,p_police_win,p_agents_lost,p_timeout,"
+                 "mean_time_units,mean_successful,mean_thwarted,mean_executed,mean_agent_survival\n");
+    fflush(out);
+    
+    int workers = options.num_workers > 0 ? options.num_workers : default_worker_count();
+    long long written = run_worker_pool(workers, sweep.num_points, sizeof(SweepPointResult),
+                                        sweep_task, sweep_result, &sweep);
+    
+    if (options.show_progress) {
+        fprintf(stderr, "Done: %lld/%lld points\n", sweep.completed, sweep.num_points);
+    }
+    fflush(out);
+    return written;
+}
@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../include/task_pool.h"
+#include "../include/sim_clock.h"
+
+// Worker running on the calling thread, NULL outside any pool
+static _Thread_local TaskWorker* current_worker = NULL;
+
+// Prepare an empty deque
+static void deque_init(TaskDeque* deque) {
+    pthread_mutex_init(&deque->lock, NULL);
+    deque->capacity = 64;
+    deque->items = (SimEvent*)malloc(deque->capacity * sizeof(SimEvent));
+    if (deque->items == NULL) {
+        perror("Failed to allocate task deque");
+        exit(1);
+    }
+    deque->head = 0;
+    deque->count = 0;
+}
+
+// Add an event at the tail, growing the ring if needed
+static void deque_push(TaskDeque* deque, const SimEvent* event) {
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity) {
+        SimEvent* items = (SimEvent*)malloc(2 * deque->capacity * sizeof(SimEvent));
+        if (items == NULL) {
+            perror("Failed to grow task deque");
+            exit(1);
+        }
+        for (int i = 0; i < deque->count; i++) {
+            items[i] = deque->items[(deque->head + i) % deque->capacity];
+        }
+        free(deque->items);
+        deque->items = items;
+        deque->head = 0;
+        deque->capacity *= 2;
+    }
+    deque->items[(deque->head + deque->count) % deque->capacity] = *event;
+    deque->count++;
+    pthread_mutex_unlock(&deque->lock);
+}
+
+// Take the newest event (owner side)
+static bool deque_pop(TaskDeque* deque, SimEvent* event) {
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        deque->count--;
+        *event = deque->items[(deque->head + deque->count) % deque->capacity];
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Take the oldest event (thief side)
+static bool deque_steal(TaskDeque* deque, SimEvent* event) {
+    bool found = false;
+    pthread_mutex_lock(&deque->lock);
+    if (deque->count > 0) {
+        *event = deque->items[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+        deque->count--;
+        found = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return found;
+}
+
+// Release deque storage
+static void deque_destroy(TaskDeque* deque) {
+    pthread_mutex_destroy(&deque->lock);
+    free(deque->items);
+}
+
+// Put a ready event in a deque and wake an idle worker. The counter is
+// raised before taking the pool lock, and idle workers check it under that
+// lock before waiting, so the wakeup cannot be lost.
+static void make_ready(TaskPool* pool, TaskWorker* worker, const SimEvent* event) {
+    deque_push(&worker->deque, event);
+    atomic_fetch_add(&pool->num_ready, 1);
+    
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Worker that receives an event submitted by the calling thread
+static TaskWorker* submit_target(TaskPool* pool) {
+    if (current_worker != NULL && current_worker->pool == pool) {
+        return current_worker;
+    }
+    unsigned int next = atomic_fetch_add(&pool->next_worker, 1);
+    return &pool->workers[next % pool->num_workers];
+}
+
+// Own work first, then steal from the other workers in turn
+static bool find_task(TaskWorker* worker, SimEvent* event) {
+    TaskPool* pool = worker->pool;
+    if (deque_pop(&worker->deque, event)) {
+        return true;
+    }
+    for (int i = 1; i < pool->num_workers; i++) {
+        TaskWorker* victim = &pool->workers[(worker->index + i) % pool->num_workers];
+        if (deque_steal(&victim->deque, event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Absolute CLOCK_MONOTONIC deadline ms from now
+static struct timespec deadline_after_ms(long long ms) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+// Worker thread: run ready events; when there are none, move due timers
+// into the own deque or sleep until the next one is due
+static void* worker_main(void* arg) {
+    TaskWorker* worker = (TaskWorker*)arg;
+    TaskPool* pool = worker->pool;
+    current_worker = worker;
+    SimEvent event;
+    
+    while (!atomic_load(&pool->stop)) {
+        if (find_task(worker, &event)) {
+            atomic_fetch_sub(&pool->num_ready, 1);
+            pool->handler(&event, pool->ctx);
+            continue;
+        }
+        
+        pthread_mutex_lock(&pool->lock);
+        if (atomic_load(&pool->stop)) {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        
+        long long now = sim_clock_now_ms();
+        int released = 0;
+        SimEvent next;
+        while (event_queue_peek(&pool->timers, &next) && next.time <= now) {
+            event_queue_pop(&pool->timers, &next);
+            deque_push(&worker->deque, &next);
+            atomic_fetch_add(&pool->num_ready, 1);
+            released++;
+        }
+        
+        if (released > 1) {
+            // Let the other workers steal the rest of the batch
+            pthread_cond_broadcast(&pool->wake);
+        } else if (released == 0 && atomic_load(&pool->num_ready) == 0) {
+            // Sleep until the next timer is due at the current speed; long
+            // waits are capped so a speed change is picked up promptly
+            long long wait_ms = SIM_CLOCK_MAX_SLEEP_MS;
+            if (event_queue_peek(&pool->timers, &next)) {
+                wait_ms = (long long)((next.time - now) / sim_clock_get_scale()) + 1;
+                if (wait_ms > SIM_CLOCK_MAX_SLEEP_MS) {
+                    wait_ms = SIM_CLOCK_MAX_SLEEP_MS;
+                }
+            }
+            struct timespec deadline = deadline_after_ms(wait_ms);
+            pthread_cond_timedwait(&pool->wake, &pool->lock, &deadline);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    
+    current_worker = NULL;
+    return NULL;
+}
+
+// Start num_workers threads that run events through handler(event, ctx)
+void task_pool_init(TaskPool* pool, int num_workers, TaskHandlerFn handler, void* ctx) {
+    if (num_workers < 1) {
+        num_workers = 1;
+    }
+    
+    pool->num_workers = num_workers;
+    pool->handler = handler;
+    pool->ctx = ctx;
+    atomic_init(&pool->num_ready, 0);
+    atomic_init(&pool->next_worker, 0);
+    
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&pool->wake, &attr);
+    pthread_condattr_destroy(&attr);
+    
+    event_queue_init(&pool->timers, 64);
+    pool->parked_capacity = 16;
+    pool->parked = (SimEvent*)malloc(pool->parked_capacity * sizeof(SimEvent));
+    pool->num_parked = 0;
+    atomic_init(&pool->stop, false);
+    
+    pool->workers = (TaskWorker*)malloc(num_workers * sizeof(TaskWorker));
+    if (pool->workers == NULL || pool->parked == NULL) {
+        perror("Failed to allocate task pool");
+        exit(1);
+    }
+    
+    // Set up every deque before any thread can try to steal from it
+    for (int i = 0; i < num_workers; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        deque_init(&pool->workers[i].deque);
+    }
+    for (int i = 0; i < num_workers; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+            perror("Failed to create task pool worker");
+            exit(1);
+        }
+    }
+}
+
+// Run an event as soon as a worker is free
+void task_pool_submit(TaskPool* pool, EventType type, int gang_id, int member_id) {
+    SimEvent event;
+    memset(&event, 0, sizeof(event));
+    event.type = type;
+    event.gang_id = gang_id;
+    event.member_id = member_id;
+    make_ready(pool, submit_target(pool), &event);
+}
+
+// Run an event once the simulation clock reaches time (in ms)
+void task_pool_schedule(TaskPool* pool, long long time, EventType type, int gang_id, int member_id) {
+    pthread_mutex_lock(&pool->lock);
+    event_queue_push(&pool->timers, time, type, gang_id, member_id);
+    pthread_cond_signal(&pool->wake);  // The new timer may be due before the current wait ends
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Hold an event until task_pool_unpark is called for its gang. Callers must
+// serialize parking against the matching unpark (the gang parks and unparks
+// under gang_mutex) so a release is never missed.
+void task_pool_park(TaskPool* pool, const SimEvent* event) {
+    pthread_mutex_lock(&pool->lock);
+    if (pool->num_parked == pool->parked_capacity) {
+        pool->parked_capacity *= 2;
+        pool->parked = (SimEvent*)realloc(pool->parked, pool->parked_capacity * sizeof(SimEvent));
+        if (pool->parked == NULL) {
+            perror("Failed to grow parked task list");
+            exit(1);
+        }
+    }
+    pool->parked[pool->num_parked++] = *event;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Make every event parked for gang_id ready again
+void task_pool_unpark(TaskPool* pool, int gang_id) {
+    pthread_mutex_lock(&pool->lock);
+    int kept = 0;
+    int released = 0;
+    for (int i = 0; i < pool->num_parked; i++) {
+        if (pool->parked[i].gang_id == gang_id) {
+            TaskWorker* worker = &pool->workers[released++ % pool->num_workers];
+            deque_push(&worker->deque, &pool->parked[i]);
+            atomic_fetch_add(&pool->num_ready, 1);
+        } else {
+            pool->parked[kept++] = pool->parked[i];
+        }
+    }
+    pool->num_parked = kept;
+    if (released > 0) {
+        pthread_cond_broadcast(&pool->wake);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Stop the workers once their current events finish and free the pool.
+// Ready, delayed and parked events that have not run are dropped.
+void task_pool_shutdown(TaskPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    atomic_store(&pool->stop, true);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+    
+    for (int i = 0; i < pool->num_workers; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    
+    for (int i = 0; i < pool->num_workers; i++) {
+        deque_destroy(&pool->workers[i].deque);
+    }
+    free(pool->workers);
+    free(pool->parked);
+    event_queue_destroy(&pool->timers);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+}
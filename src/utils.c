@@ -3,24 +3,247 @@
 #include <stdarg.h>
 #include <unistd.h>
 #include <time.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
 #include "../include/utils.h"
 #include "../include/config.h"
 
+// Whether log_message prints anything (headless runs turn it off)
+static bool logging_enabled = true;
+
+// Seed of the current run, shared by every stream in the process
+static uint64_t run_seed = 0;
+
+// Each thread draws from its own stream, so no locking is needed and the
+// sequence a thread sees does not depend on how other threads interleave
+static _Thread_local RngStream thread_stream;
+static _Thread_local bool thread_stream_ready = false;
+static _Thread_local RngStream* current_stream = NULL;
+
+// splitmix64 finalizer: a bijective 64-bit mixing function
+static inline uint64_t rng_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Key a stream by (seed, gang_id, member_id). Distinct triples give
+// unrelated keys, so streams do not overlap.
+void rng_stream_init(RngStream* stream, uint64_t seed, int gang_id, int member_id) {
+    uint64_t id = ((uint64_t)(uint32_t)gang_id << 32) | (uint32_t)member_id;
+    stream->key = rng_mix(rng_mix(seed + 0x9E3779B97F4A7C15ULL) ^ id) | 1;
+    stream->counter = 0;
+}
+
+// Counter-based generator: output i is a keyed hash of i, so any block of
+// outputs can be produced independently
+uint64_t rng_next(RngStream* stream) {
+    uint64_t x = stream->counter++ * 0x9E3779B97F4A7C15ULL;
+    return rng_mix(rng_mix(x ^ stream->key) + stream->key);
+}
+
+// Set the run seed and reset the calling thread to the process-level stream
+void rng_set_seed(uint64_t seed) {
+    run_seed = seed;
+    rng_seed_thread(RNG_PROCESS_STREAM, RNG_PROCESS_STREAM);
+}
+
+// Seed of the current run
+uint64_t rng_get_seed(void) {
+    return run_seed;
+}
+
+// Give the calling thread its own stream keyed by (run seed, gang_id, member_id)
+void rng_seed_thread(int gang_id, int member_id) {
+    rng_stream_init(&thread_stream, run_seed, gang_id, member_id);
+    thread_stream_ready = true;
+    current_stream = &thread_stream;
+}
+
+// Draw subsequent random numbers on this thread from stream (NULL restores
+// the thread's own stream). Used by the single-threaded headless engine to
+// give every simulated actor its own stream.
+void rng_use_stream(RngStream* stream) {
+    current_stream = stream;
+}
+
+// Stream used by the calling thread
+static inline RngStream* active_stream(void) {
+    if (current_stream != NULL) {
+        return current_stream;
+    }
+    if (!thread_stream_ready) {
+        rng_stream_init(&thread_stream, run_seed, RNG_PROCESS_STREAM, RNG_PROCESS_STREAM);
+        thread_stream_ready = true;
+    }
+    return &thread_stream;
+}
+
+// Uniform integer in [0, range) without division (multiply-shift reduction)
+static inline uint32_t random_below(uint32_t range) {
+    return (uint32_t)(((rng_next(active_stream()) >> 32) * (uint64_t)range) >> 32);
+}
+
 // Generate a random integer between min and max (inclusive)
 int random_int(int min, int max) {
-    return min + rand() % (max - min + 1);
+    return min + (int)random_below((uint32_t)(max - min + 1));
 }
 
 // Generate a random double between min and max
 double random_double(double min, double max) {
-    return min + (max - min) * ((double)rand() / RAND_MAX);
+    return min + (max - min) * ((rng_next(active_stream()) >> 11) * (1.0 / 9007199254740992.0));
 }
 
 // Determine if an event occurs with the given probability percentage
 bool random_event(int probability_percentage) {
-    return (rand() % 100) < probability_percentage;
+    return (int)random_below(100) < probability_percentage;
+}
+
+// 32-bit integer hash (lowbias32), in scalar and 4-lane form. The block
+// kernel below uses it because 32-bit multiplies vectorize on every x86-64
+// target while 64-bit ones do not.
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+typedef int32_t i32x4 __attribute__((vector_size(16)));
+
+static inline uint32_t rng_mix32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x21F0AAADU;
+    x ^= x >> 15;
+    x *= 0xD35A2D97U;
+    x ^= x >> 15;
+    return x;
+}
+
+static inline u32x4 rng_mix32x4(u32x4 x) {
+    x ^= x >> 16;
+    x *= 0x21F0AAADU;
+    x ^= x >> 15;
+    x *= 0xD35A2D97U;
+    x ^= x >> 15;
+    return x;
+}
+
+// Threshold for random_events_fill: an event with this percentage happens
+// when a 31-bit random word is below it. 0% and 100% are exact.
+uint32_t probability_threshold(int probability_percentage) {
+    if (probability_percentage <= 0) {
+        return 0;
+    }
+    if (probability_percentage >= 100) {
+        return 1U << 31;
+    }
+    return (uint32_t)(((uint64_t)probability_percentage << 31) / 100);
+}
+
+// Words [0, n) of random_events_fill for a span in which the low half of
+// the counter does not wrap, so every word shares the high half
+static void random_events_span(RngStream* stream, const uint32_t* restrict thresholds,
+                               uint8_t* restrict outcomes, int n) {
+    uint32_t base = (uint32_t)stream->counter;
+    uint32_t key_lo = (uint32_t)stream->key;
+    uint32_t key_hi = (uint32_t)(stream->key >> 32) ^ (uint32_t)(stream->counter >> 32);
+    int i = 0;
+    
+    for (; i + 4 <= n; i += 4) {
+        u32x4 counter = base + (u32x4){(uint32_t)i, (uint32_t)i + 1, (uint32_t)i + 2, (uint32_t)i + 3};
+        u32x4 word = rng_mix32x4(rng_mix32x4(counter ^ key_lo) + key_hi);
+        u32x4 threshold;
+        memcpy(&threshold, thresholds + i, sizeof(threshold));
+        i32x4 hit = (word >> 1) < threshold;  // -1 where the event happens, 0 elsewhere
+        for (int lane = 0; lane < 4; lane++) {
+            outcomes[i + lane] = (uint8_t)(hit[lane] & 1);
+        }
+    }
+    
+    for (; i < n; i++) {
+        uint32_t word = rng_mix32(rng_mix32((base + (uint32_t)i) ^ key_lo) + key_hi);
+        outcomes[i] = (word >> 1) < thresholds[i];
+    }
+    
+    stream->counter += (uint64_t)n;
+}
+
+// Draw n independent events at once: outcomes[i] = 1 with the probability
+// encoded in thresholds[i]. Word i is a keyed hash of counter + i: the
+// vector kernel hashes the low 32 bits, with the high 32 bits folded into
+// the key, so four words are generated per SIMD step and the outcome is a
+// plain compare with no branches. A fill that reaches a 2^32 boundary of the
+// counter is split there. The scalar tail produces the same words as the
+// vector body.
+void random_events_fill(const uint32_t* restrict thresholds, uint8_t* restrict outcomes, int n) {
+    RngStream* stream = active_stream();
+    while (n > 0) {
+        uint64_t until_wrap = ((uint64_t)1 << 32) - (uint32_t)stream->counter;
+        int span = (uint64_t)n < until_wrap ? n : (int)until_wrap;
+        random_events_span(stream, thresholds, outcomes, span);
+        thresholds += span;
+        outcomes += span;
+        n -= span;
+    }
+}
+
+// Number of successes in n trials with success probability p. Small means
+// use CDF inversion; larger ones use Hormann's BTRS transformed rejection,
+// which needs O(1) expected uniforms regardless of n.
+int random_binomial(int n, double p) {
+    if (n <= 0 || p <= 0.0) {
+        return 0;
+    }
+    if (p >= 1.0) {
+        return n;
+    }
+    if (p > 0.5) {
+        return n - random_binomial(n, 1.0 - p);
+    }
+    
+    double q = 1.0 - p;
+    
+    if (n * p < 10.0) {
+        // Inversion: walk the CDF from 0 using the pmf recurrence
+        double s = p / q;
+        double a = (n + 1) * s;
+        double r = pow(q, n);
+        double u = random_double(0.0, 1.0);
+        int x = 0;
+        while (u > r && x < n) {
+            u -= r;
+            x++;
+            r *= a / x - s;
+        }
+        return x;
+    }
+    
+    double spq = sqrt(n * p * q);
+    double b = 1.15 + 2.53 * spq;
+    double a = -0.0873 + 0.0248 * b + 0.01 * p;
+    double c = n * p + 0.5;
+    double v_r = 0.92 - 4.2 / b;
+    double alpha = (2.83 + 5.1 / b) * spq;
+    double lpq = log(p / q);
+    int m = (int)floor((n + 1) * p);
+    double h = lgamma(m + 1.0) + lgamma(n - m + 1.0);
+    
+    while (1) {
+        double u = random_double(0.0, 1.0) - 0.5;
+        double v = random_double(0.0, 1.0);
+        double us = 0.5 - fabs(u);
+        int k = (int)floor((2.0 * a / us + b) * u + c);
+        if (k < 0 || k > n) {
+            continue;
+        }
+        if (us >= 0.07 && v <= v_r) {
+            return k;
+        }
+        v = log(v * alpha / (a / (us * us) + b));
+        if (v <= h - lgamma(k + 1.0) - lgamma(n - k + 1.0) + (k - m) * lpq) {
+            return k;
+        }
+    }
 }
 
 // Delay execution for the specified number of milliseconds
@@ -31,8 +254,30 @@ void delay_ms(int milliseconds) {
     nanosleep(&ts, NULL);
 }
 
+// Sleep on a futex word while it holds expected, until woken or timeout
+// passes (NULL waits indefinitely). The word may live in shared memory, so
+// the process-private futex operations are not used. Returns 0, or -1 with
+// errno ETIMEDOUT, EAGAIN (the word had changed) or EINTR.
+int futex_wait(atomic_uint* word, unsigned int expected, const struct timespec* timeout) {
+    return (int)syscall(SYS_futex, word, FUTEX_WAIT, expected, timeout, NULL, 0);
+}
+
+// Wake up to waiters threads sleeping on a futex word
+void futex_wake(atomic_uint* word, int waiters) {
+    syscall(SYS_futex, word, FUTEX_WAKE, waiters, NULL, NULL, 0);
+}
+
+// Enable or disable log_message output
+void set_logging_enabled(bool enabled) {
+    logging_enabled = enabled;
+}
+
 // Log a message with timestamp
 void log_message(const char* format, ...) {
+    if (!logging_enabled) {
+        return;
+    }
+    
     // Get current time
     time_t now = time(NULL);
     struct tm* tm_info = localtime(&now);
@@ -12,6 +12,7 @@
 #include "../include/police.h"
 #include "../include/utils.h"
 #include "../include/ipc.h"
+#include "../include/sim_clock.h"
 
 // Global visualization context is declared as extern in the header
 // No need to redefine it here
@@ -302,6 +303,17 @@ void keyboard_function(unsigned char key, int x, int y) {
             pthread_mutex_unlock(&viz_context.mutex);
             glutPostRedisplay();
             break;
+        // '>' and '<' keys double or halve the simulation speed
+        case '>':
+        case '.':
+            sim_clock_set_scale(sim_clock_get_scale() * 2.0);
+            glutPostRedisplay();
+            break;
+        case '<':
+        case ',':
+            sim_clock_set_scale(sim_clock_get_scale() / 2.0);
+            glutPostRedisplay();
+            break;
         // 'h' key to reset to home position (top of lists)
         case 'h':
         case 'H':
@@ -499,12 +511,9 @@ void draw_status_bar(VisualizationContext* ctx) {
     
     char buffer[100];
     
-    // Show current time
-    time_t now = time(NULL);
-    struct tm* timeinfo = localtime(&now);
-    
-    sprintf(buffer, "Simulation Time: %02d:%02d:%02d | Status: %s", 
-            timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec,
+    // Show simulated time (in time units) and the current speed
+    sprintf(buffer, "Simulation Time: %.1f units | Speed: %.3gx | Status: %s", 
+            sim_clock_now_ms() / (double)SIM_TIME_UNIT_MS, sim_clock_get_scale(),
             ctx->simulation_running ? "Running" : "Stopped");
     
     for (int i = 0; i < strlen(buffer); i++) {
@@ -513,18 +522,19 @@ void draw_status_bar(VisualizationContext* ctx) {
     
     // Show termination condition if available
     if (ctx->shared_state != NULL) {
-        if (ctx->shared_state->total_successful_missions >= ctx->config.max_successful_plans) {
+        SharedTotals totals = shared_totals(ctx->shared_state);
+        if (totals.successful_missions >= ctx->config.max_successful_plans) {
             glColor3f(1.0f, 0.5f, 0.0f); // Orange for gangs winning
             glRasterPos2f(ctx->window_width - 200, ctx->window_height - 20);
-            sprintf(buffer, "Gangs Win! (%d missions)", ctx->shared_state->total_successful_missions);
-        } else if (ctx->shared_state->total_thwarted_missions >= ctx->config.max_thwarted_plans) {
+            sprintf(buffer, "Gangs Win! (%d missions)", totals.successful_missions);
+        } else if (totals.thwarted_missions >= ctx->config.max_thwarted_plans) {
             glColor3f(0.0f, 0.7f, 1.0f); // Blue for police winning
             glRasterPos2f(ctx->window_width - 200, ctx->window_height - 20);
-            sprintf(buffer, "Police Win! (%d thwarts)", ctx->shared_state->total_thwarted_missions);
-        } else if (ctx->shared_state->total_executed_agents >= ctx->config.max_executed_agents) {
+            sprintf(buffer, "Police Win! (%d thwarts)", totals.thwarted_missions);
+        } else if (totals.executed_agents >= ctx->config.max_executed_agents) {
             glColor3f(1.0f, 0.0f, 0.0f); // Red for agents executed
             glRasterPos2f(ctx->window_width - 200, ctx->window_height - 20);
-            sprintf(buffer, "Agents Lost! (%d executed)", ctx->shared_state->total_executed_agents);
+            sprintf(buffer, "Agents Lost! (%d executed)", totals.executed_agents);
         } else {
             // Still running
             buffer[0] = '\0';
@@ -989,6 +999,7 @@ void draw_counters(int x, int y, int width, int height) {
     
     // Only proceed if we have valid shared state
     if (!shared_state) return;
+    SharedTotals totals = shared_totals(shared_state);
     
     // Draw section title
     glColor3f(1.0f, 1.0f, 1.0f);  // White text
@@ -1020,7 +1031,7 @@ void draw_counters(int x, int y, int width, int height) {
     // Draw counter value with max
     char thwarted_value[30];
     sprintf(thwarted_value, "%d / %d", 
-            shared_state->total_thwarted_missions,
+            totals.thwarted_missions,
             config.max_thwarted_plans);
     
     glRasterPos2f(x + 20, counter_y - 20);
@@ -1040,7 +1051,7 @@ void draw_counters(int x, int y, int width, int height) {
     // Draw counter value with max
     char succeeded_value[30];
     sprintf(succeeded_value, "%d / %d", 
-            shared_state->total_successful_missions,
+            totals.successful_missions,
             config.max_successful_plans);
     
     glRasterPos2f(x + 20, counter_y - 20);
@@ -1060,7 +1071,7 @@ void draw_counters(int x, int y, int width, int height) {
     // Draw counter value with max
     char executed_value[30];
     sprintf(executed_value, "%d / %d", 
-            shared_state->total_executed_agents,
+            totals.executed_agents,
             config.max_executed_agents);
     
     glRasterPos2f(x + 20, counter_y - 20);
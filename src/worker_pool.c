@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "../include/worker_pool.h"
+
+// Task dispenser shared between the parent and its workers
+typedef struct {
+    atomic_llong next_task;
+    atomic_int stop;
+} PoolControl;
+
+// Number of online CPUs, used as the default worker count
+int default_worker_count(void) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
+
+// Worker process: claim task indices until none are left, send each result up the pipe
+static void worker_main(PoolControl* control, int write_fd, long long num_tasks, size_t result_size,
+                        WorkerTaskFn task, void* ctx) {
+    char record[sizeof(long long) + WORKER_MAX_RESULT_SIZE];
+    
+    while (!atomic_load(&control->stop)) {
+        long long index = atomic_fetch_add(&control->next_task, 1);
+        if (index >= num_tasks) {
+            break;
+        }
+        
+        memset(record, 0, sizeof(record));
+        memcpy(record, &index, sizeof(index));
+        task(index, record + sizeof(index), ctx);
+        
+        // Records are smaller than PIPE_BUF, so concurrent writes never interleave
+        if (write(write_fd, record, sizeof(index) + result_size) == -1) {
+            perror("Worker failed to write result");
+            break;
+        }
+    }
+    
+    close(write_fd);
+    _exit(0);
+}
+
+// Read exactly size bytes unless the pipe reaches end of file
+static bool read_record(int fd, char* buffer, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = read(fd, buffer + done, size - done);
+        if (n == 0) {
+            return false;
+        }
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("Failed to read worker result");
+            return false;
+        }
+        done += n;
+    }
+    return true;
+}
+
+// Run num_tasks tasks on num_workers forked processes. Tasks are handed out
+// dynamically through a shared counter, so uneven task lengths still keep all
+// workers busy. Results are streamed back to on_result without being stored.
+// Returns the number of results delivered.
+long long run_worker_pool(int num_workers, long long num_tasks, size_t result_size,
+                          WorkerTaskFn task, WorkerResultFn on_result, void* ctx) {
+    if (result_size > WORKER_MAX_RESULT_SIZE) {
+        fprintf(stderr, "Error: worker result of %zu bytes exceeds the %d byte limit\n",
+                result_size, WORKER_MAX_RESULT_SIZE);
+        exit(1);
+    }
+    if (num_workers < 1) {
+        num_workers = 1;
+    }
+    if (num_workers > num_tasks) {
+        num_workers = num_tasks > 0 ? (int)num_tasks : 1;
+    }
+    
+    PoolControl* control = (PoolControl*)mmap(NULL, sizeof(PoolControl), PROT_READ | PROT_WRITE,
+                                              MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (control == MAP_FAILED) {
+        perror("Failed to map worker pool control block");
+        exit(1);
+    }
+    atomic_init(&control->next_task, 0);
+    atomic_init(&control->stop, 0);
+    
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("Failed to create worker pipe");
+        exit(1);
+    }
+    
+    // Flush buffered output so workers do not print it again
+    fflush(stdout);
+    fflush(stderr);
+    
+    pid_t* pids = (pid_t*)malloc(num_workers * sizeof(pid_t));
+    for (int i = 0; i < num_workers; i++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("Fork failed");
+            exit(1);
+        }
+        else if (pid == 0) {
+            close(fds[0]);
+            worker_main(control, fds[1], num_tasks, result_size, task, ctx);
+        }
+        pids[i] = pid;
+    }
+    close(fds[1]);
+    
+    // Stream results as they arrive
+    long long delivered = 0;
+    char record[sizeof(long long) + WORKER_MAX_RESULT_SIZE];
+    while (read_record(fds[0], record, sizeof(long long) + result_size)) {
+        long long index;
+        memcpy(&index, record, sizeof(index));
+        delivered++;
+        
+        if (!on_result(index, record + sizeof(index), ctx)) {
+            atomic_store(&control->stop, 1);
+        }
+    }
+    close(fds[0]);
+    
+    for (int i = 0; i < num_workers; i++) {
+        waitpid(pids[i], NULL, 0);
+    }
+    free(pids);
+    munmap(control, sizeof(PoolControl));
+    
+    return delivered;
+}
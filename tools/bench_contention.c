@@ -0,0 +1,139 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <limits.h>
+#include <pthread.h>
+#include <time.h>
+#include "../include/config.h"
+#include "../include/gang.h"
+#include "../include/police.h"
+#include "../include/utils.h"
+
+// Gang size and ticks per thread in each measurement
+#define BENCH_MEMBERS 256
+#define TICKS_PER_THREAD 20000
+#define MAX_THREADS 64
+
+// How a benchmark thread synchronizes its ticks
+typedef enum {
+    TICK_LOCKED,     // gang_mutex held around every tick, as member ticks used to run
+    TICK_LOCK_FREE   // gang_member_tick on its own
+} TickMode;
+
+typedef struct {
+    Gang* gang;
+    TickMode mode;
+    int thread_id;
+    int first_member;   // Members [first_member, first_member + num_members) belong to this thread
+    int num_members;
+    long reports;       // Keeps the compiler from discarding the ticks
+} BenchThread;
+
+// Ticking threads still running
+static atomic_int running;
+
+// Benchmark thread: TICKS_PER_THREAD ticks over its own members
+static void* bench_thread(void* arg) {
+    BenchThread* bench = (BenchThread*)arg;
+    Gang* gang = bench->gang;
+    IntelligenceReport report;
+    long reports = 0;
+    
+    rng_seed_thread(0, bench->thread_id);
+    for (long i = 0; i < TICKS_PER_THREAD; i++) {
+        int member_id = bench->first_member + (int)(i % bench->num_members);
+        if (bench->mode == TICK_LOCKED) {
+            pthread_mutex_lock(&gang->gang_mutex);
+            reports += gang_member_tick(gang, member_id, &report);
+            pthread_mutex_unlock(&gang->gang_mutex);
+        } else {
+            reports += gang_member_tick(gang, member_id, &report);
+        }
+    }
+    
+    bench->reports = reports;
+    atomic_fetch_sub(&running, 1);
+    return NULL;
+}
+
+// Run num_threads ticking threads while the calling thread starts a mission
+// transition about once per millisecond. Returns nanoseconds per tick (wall
+// time / total ticks) and the mean transition latency in microseconds.
+static double run_bench(Gang* gang, TickMode mode, int num_threads, double* transition_us) {
+    pthread_t threads[MAX_THREADS];
+    BenchThread benches[MAX_THREADS];
+    struct timespec start, end;
+    int per_thread = BENCH_MEMBERS / num_threads;
+    
+    atomic_store(&running, num_threads);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < num_threads; i++) {
+        benches[i].gang = gang;
+        benches[i].mode = mode;
+        benches[i].thread_id = i;
+        benches[i].first_member = i * per_thread;
+        benches[i].num_members = per_thread;
+        pthread_create(&threads[i], NULL, bench_thread, &benches[i]);
+    }
+    
+    // Transitions in the locked mode are plain lock/unlock pairs, matching
+    // how mission phases and ticks used to share gang_mutex
+    int num_transitions = 0;
+    double transition_ns = 0;
+    struct timespec pause = {0, 1000000L};
+    while (atomic_load(&running) > 0) {
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        if (mode == TICK_LOCKED) {
+            pthread_mutex_lock(&gang->gang_mutex);
+            pthread_mutex_unlock(&gang->gang_mutex);
+        } else {
+            begin_mission_transition(gang);
+            end_mission_transition(gang);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        transition_ns += (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+        num_transitions++;
+        nanosleep(&pause, NULL);
+    }
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    *transition_us = num_transitions > 0 ? transition_ns / num_transitions / 1000.0 : 0.0;
+    double elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    return elapsed_ns / ((double)TICKS_PER_THREAD * num_threads);
+}
+
+int main(int argc, char* argv[]) {
+    const char* config_file = argc > 1 ? argv[1] : "config/simulation_config.txt";
+    int max_threads = argc > 2 ? atoi(argv[2]) : 8;
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > MAX_THREADS) max_threads = MAX_THREADS;
+    
+    SimulationConfig config = load_config(config_file);
+    config.exchange_model = EXCHANGE_PAIRWISE;
+    set_logging_enabled(false);
+    rng_set_seed(1);
+    
+    // A target no member reaches keeps every tick doing the full exchange
+    Gang gang;
+    initialize_gang_state(&gang, 0, BENCH_MEMBERS, config.gang_ranks, config);
+    gang.required_preparation_level = INT_MAX;
+    
+    printf("Member tick contention, %d members, %d ticks per thread\n", BENCH_MEMBERS, TICKS_PER_THREAD);
+    printf("%8s %16s %16s %10s %16s %16s\n", "threads", "locked ns/tick", "lock-free ns/tick",
+           "speedup", "locked trans us", "lock-free trans us");
+    for (int threads = 1; threads <= max_threads && threads <= BENCH_MEMBERS; threads *= 2) {
+        double locked_trans, free_trans;
+        double locked_ns = run_bench(&gang, TICK_LOCKED, threads, &locked_trans);
+        double free_ns = run_bench(&gang, TICK_LOCK_FREE, threads, &free_trans);
+        printf("%8d %16.1f %16.1f %9.1fx %16.1f %16.1f\n", threads, locked_ns, free_ns,
+               locked_ns / free_ns, locked_trans, free_trans);
+    }
+    
+    cleanup_gang(&gang);
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include "../include/config.h"
+#include "../include/ipc.h"
+#include "../include/police.h"
+#include "../include/utils.h"
+
+// Reports queued per round and rounds per measurement
+#define REPORTS_PER_ROUND 256
+#define ROUNDS 2000
+#define BENCH_GANGS 8
+
+// Reports each producer thread sends in the streaming measurement
+#define STREAM_REPORTS 1000000
+#define MAX_PRODUCERS 16
+
+// Report number i of a round, spread over BENCH_GANGS gangs
+static IntelligenceReport bench_report(int round, int i) {
+    IntelligenceReport report;
+    report.gang_id = (round + i) % BENCH_GANGS;
+    report.agent_id = i;
+    report.suspected_target = (CrimeType)(i % NUM_CRIME_TYPES);
+    report.suspicion_level = 20 + i % 40;
+    report.is_reliable = i % 3 != 0;
+    report.time_ms = (long long)round * 10;
+    return report;
+}
+
+// Queue a round of reports
+static void queue_round(int queue_id, int round) {
+    for (int i = 0; i < REPORTS_PER_ROUND; i++) {
+        send_report(queue_id, bench_report(round, i));
+    }
+}
+
+typedef struct {
+    int queue_id;
+    int thread_id;
+} Producer;
+
+// Streaming producer: sends STREAM_REPORTS reports, yielding while the ring is full
+static void* producer_thread(void* arg) {
+    Producer* producer = (Producer*)arg;
+    for (int i = 0; i < STREAM_REPORTS; i++) {
+        while (send_report(producer->queue_id, bench_report(producer->thread_id, i)) == -1 &&
+               errno == EAGAIN) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+// Stream reports from num_producers threads while the calling thread drains
+// them (without handling them). Returns reports per second through the ring.
+static double run_stream(int queue_id, int num_producers) {
+    pthread_t threads[MAX_PRODUCERS];
+    Producer producers[MAX_PRODUCERS];
+    IntelligenceReport reports[POLICE_INTAKE_BATCH];
+    struct timespec start, end;
+    long expected = (long)STREAM_REPORTS * num_producers;
+    long received = 0;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < num_producers; i++) {
+        producers[i].queue_id = queue_id;
+        producers[i].thread_id = i;
+        pthread_create(&threads[i], NULL, producer_thread, &producers[i]);
+    }
+    while (received < expected) {
+        received += receive_reports_timed(queue_id, reports, POLICE_INTAKE_BATCH,
+                                          POLICE_INTAKE_TIMEOUT_MS);
+    }
+    for (int i = 0; i < num_producers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    double elapsed_s = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    return received / elapsed_s;
+}
+
+// Drain ROUNDS rounds of reports, one report per receive and handle call or
+// in batches of up to POLICE_INTAKE_BATCH. Returns nanoseconds per report,
+// counting only the draining.
+static double run_bench(int queue_id, SimulationConfig config, SharedState* state, bool batched) {
+    Police police;
+    initialize_police(&police, config);
+    police.shared_state = state;
+    
+    IntelligenceReport reports[POLICE_INTAKE_BATCH];
+    double elapsed_ns = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        police.virtual_now_ms = (long long)round * 10;
+        queue_round(queue_id, round);
+        
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int remaining = REPORTS_PER_ROUND;
+        while (remaining > 0) {
+            if (batched) {
+                int received = receive_reports_timed(queue_id, reports, POLICE_INTAKE_BATCH,
+                                                     POLICE_INTAKE_TIMEOUT_MS);
+                police_handle_reports(&police, reports, received, config);
+                remaining -= received;
+            } else if (receive_report_timed(queue_id, &reports[0], POLICE_INTAKE_TIMEOUT_MS) > 0) {
+                police_handle_report(&police, reports[0], config);
+                remaining--;
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        elapsed_ns += (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    }
+    
+    cleanup_police(&police);
+    return elapsed_ns / ((double)ROUNDS * REPORTS_PER_ROUND);
+}
+
+int main(int argc, char* argv[]) {
+    const char* config_file = argc > 1 ? argv[1] : "config/simulation_config.txt";
+    SimulationConfig config = load_config(config_file);
+    set_logging_enabled(false);
+    rng_set_seed(1);
+    
+    int max_producers = argc > 2 ? atoi(argv[2]) : 4;
+    if (max_producers < 1) max_producers = 1;
+    if (max_producers > MAX_PRODUCERS) max_producers = MAX_PRODUCERS;
+    
+    int queue_id = create_report_queue();
+    SharedState* state = (SharedState*)aligned_alloc(CACHE_LINE_SIZE, shared_state_size(BENCH_GANGS));
+    init_shared_state(state, BENCH_GANGS);
+    
+    printf("Police report intake, %d rounds of %d reports over %d gangs\n",
+           ROUNDS, REPORTS_PER_ROUND, BENCH_GANGS);
+    double single_ns = run_bench(queue_id, config, state, false);
+    double batched_ns = run_bench(queue_id, config, state, true);
+    printf("%20s %16s %10s\n", "per-report ns", "batched ns", "speedup");
+    printf("%20.1f %16.1f %9.1fx\n", single_ns, batched_ns, single_ns / batched_ns);
+    
+    printf("\nReport ring streaming, %d reports per producer\n", STREAM_REPORTS);
+    printf("%10s %20s\n", "producers", "reports/s");
+    for (int producers = 1; producers <= max_producers; producers *= 2) {
+        printf("%10d %20.0f\n", producers, run_stream(queue_id, producers));
+    }
+    
+    destroy_report_queue(queue_id);
+    free(state);
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <time.h>
+#include "../include/utils.h"
+
+// Draws per thread in each measurement
+#define DRAWS_PER_THREAD 10000000
+#define MAX_THREADS 64
+
+// Which generator a benchmark thread exercises
+typedef enum {
+    GENERATOR_LIBC_RAND,
+    GENERATOR_STREAM
+} Generator;
+
+typedef struct {
+    Generator generator;
+    int thread_id;
+    long hits;   // Keeps the compiler from discarding the draws
+} BenchThread;
+
+// The random_event implementation this project used before per-thread streams
+static bool libc_random_event(int probability_percentage) {
+    return (rand() % 100) < probability_percentage;
+}
+
+// Benchmark thread: draw DRAWS_PER_THREAD events from one generator
+static void* bench_thread(void* arg) {
+    BenchThread* bench = (BenchThread*)arg;
+    long hits = 0;
+    
+    if (bench->generator == GENERATOR_LIBC_RAND) {
+        for (long i = 0; i < DRAWS_PER_THREAD; i++) {
+            hits += libc_random_event(30);
+        }
+    } else {
+        rng_seed_thread(0, bench->thread_id);
+        for (long i = 0; i < DRAWS_PER_THREAD; i++) {
+            hits += random_event(30);
+        }
+    }
+    
+    bench->hits = hits;
+    return NULL;
+}
+
+// Run num_threads threads on one generator; returns nanoseconds per draw (wall time / total draws)
+static double run_bench(Generator generator, int num_threads) {
+    pthread_t threads[MAX_THREADS];
+    BenchThread benches[MAX_THREADS];
+    struct timespec start, end;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < num_threads; i++) {
+        benches[i].generator = generator;
+        benches[i].thread_id = i;
+        pthread_create(&threads[i], NULL, bench_thread, &benches[i]);
+    }
+    for (int i = 0; i < num_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    double elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    return elapsed_ns / ((double)DRAWS_PER_THREAD * num_threads);
+}
+
+int main(int argc, char* argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : 8;
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > MAX_THREADS) max_threads = MAX_THREADS;
+    
+    srand(1);
+    rng_set_seed(1);
+    
+    printf("random_event throughput, %d draws per thread\n", DRAWS_PER_THREAD);
+    printf("%8s %18s %18s %10s\n", "threads", "rand() ns/draw", "stream ns/draw", "speedup");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double libc_ns = run_bench(GENERATOR_LIBC_RAND, threads);
+        double stream_ns = run_bench(GENERATOR_STREAM, threads);
+        printf("%8d %18.2f %18.2f %9.1fx\n", threads, libc_ns, stream_ns, libc_ns / stream_ns);
+    }
+    
+    return 0;
+}
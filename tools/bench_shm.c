@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/config.h"
+#include "../include/ipc.h"
+#include "../include/utils.h"
+
+// Gangs in the measured segment, enough for a state table of tens of MB
+#define BENCH_GANGS 200000
+#define PASSES 20
+
+// Keeps the sweeps from being optimized away
+static volatile long long sink;
+
+typedef struct {
+    const char* name;
+    ShmBackend backend;
+    bool prefault;
+    ShmHugePages huge_pages;
+} ShmMode;
+
+static double elapsed_ms(struct timespec start, struct timespec end) {
+    return (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+// Create, attach and initialize the segment, then make PASSES sweeps over
+// every gang's status the way the visualizer does. Prints the startup time
+// (create to initialized) and the time per sweep.
+static void run_mode(ShmMode mode, SimulationConfig config) {
+    config.shm_backend = mode.backend;
+    config.shm_prefault = mode.prefault;
+    config.shm_huge_pages = mode.huge_pages;
+    
+    struct timespec start, ready, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int shm_id = create_shared_memory(BENCH_GANGS, config);
+    SharedState* state = attach_shared_memory(shm_id);
+    init_shared_state(state, BENCH_GANGS);
+    clock_gettime(CLOCK_MONOTONIC, &ready);
+    
+    long long sum = 0;
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (int i = 0; i < BENCH_GANGS; i++) {
+            GangStatus* status = &shared_gang_slot(state, i)->status;
+            atomic_fetch_add_explicit(&status->num_members, 1, memory_order_relaxed);
+            sum += atomic_load_explicit(&status->preparation_level, memory_order_relaxed);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    sink = sum;
+    
+    printf("%-24s %14.2f %14.3f\n", mode.name, elapsed_ms(start, ready),
+           elapsed_ms(ready, end) / PASSES);
+    
+    detach_shared_memory(state);
+    destroy_shared_memory(shm_id);
+}
+
+int main(int argc, char* argv[]) {
+    const char* config_file = argc > 1 ? argv[1] : "config/simulation_config.txt";
+    SimulationConfig config = load_config(config_file);
+    set_logging_enabled(false);
+    
+    ShmMode modes[] = {
+        {"sysv", SHM_BACKEND_SYSV, false, SHM_HUGE_PAGES_NONE},
+        {"posix", SHM_BACKEND_POSIX, false, SHM_HUGE_PAGES_NONE},
+        {"posix prefault", SHM_BACKEND_POSIX, true, SHM_HUGE_PAGES_NONE},
+        {"posix thp", SHM_BACKEND_POSIX, false, SHM_HUGE_PAGES_TRANSPARENT},
+        {"posix thp prefault", SHM_BACKEND_POSIX, true, SHM_HUGE_PAGES_TRANSPARENT},
+        {"posix explicit prefault", SHM_BACKEND_POSIX, true, SHM_HUGE_PAGES_EXPLICIT},
+    };
+    
+    printf("Shared state for %d gangs (%zu bytes), %d sweeps\n",
+           BENCH_GANGS, shared_state_size(BENCH_GANGS), PASSES);
+    printf("%-24s %14s %14s\n", "backend", "startup ms", "sweep ms");
+    for (size_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+        run_mode(modes[i], config);
+    }
+    return 0;
+}
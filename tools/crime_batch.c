@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "../include/config.h"
+#include "../include/batch.h"
+#include "../include/worker_pool.h"
+
+// Print command line usage
+static void print_usage(const char* program) {
+    printf("Usage: %s <config_file> [options]\n", program);
+    printf("  --runs N         Maximum number of simulations (default 1000)\n");
+    printf("  --jobs N         Worker processes (default: one per CPU)\n");
+    printf("  --seed N         Base seed; run i uses seed N + i (default: SEED from the config, else current time)\n");
+    printf("  --precision P    Stop once the 95%% CI half-width of P(police win) is <= P\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    BatchOptions options;
+    options.max_runs = 1000;
+    options.num_workers = 0;
+    options.base_seed = (uint64_t)time(NULL);
+    options.target_precision = 0.0;
+    
+    const char* config_file = NULL;
+    bool seed_given = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            options.max_runs = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            options.num_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.base_seed = strtoull(argv[++i], NULL, 10);
+            seed_given = true;
+        } else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc) {
+            options.target_precision = atof(argv[++i]);
+        } else if (argv[i][0] != '-' && config_file == NULL) {
+            config_file = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (config_file == NULL || options.max_runs <= 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    SimulationConfig config = load_config(config_file);
+    if (!seed_given && config.seed != 0) {
+        options.base_seed = config.seed;
+    }
+    
+    int workers = options.num_workers > 0 ? options.num_workers : default_worker_count();
+    printf("Running up to %lld simulations on %d workers (base seed %" PRIu64 ")\n",
+           options.max_runs, workers, options.base_seed);
+    
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    BatchSummary summary = run_batch(config, options);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    
+    print_batch_summary(summary);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("Completed in %.2f s (%.0f runs/s)\n", elapsed, elapsed > 0 ? summary.runs / elapsed : 0.0);
+    
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "../include/config.h"
+#include "../include/sweep.h"
+#include "../include/worker_pool.h"
+
+// Print command line usage
+static void print_usage(const char* program) {
+    printf("Usage: %s <sweep_config_file> [options]\n", program);
+    printf("  --out FILE       CSV output file (default: stdout)\n");
+    printf("  --jobs N         Worker processes (default: one per CPU)\n");
+    printf("  --seed N         Base seed for sampling and runs (default: current time)\n");
+    printf("\nIn the config file, KEY=min..max:step sweeps a grid and KEY=min..max\n");
+    printf("samples a range; SWEEP_SAMPLES=N draws N random points instead of the\n");
+    printf("full grid and SWEEP_RUNS=R runs R simulations per point.\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    SweepOptions options;
+    options.num_workers = 0;
+    options.base_seed = (uint64_t)time(NULL);
+    options.output = stdout;
+    options.show_progress = true;
+    
+    const char* config_file = NULL;
+    const char* output_file = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            options.num_workers = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            options.base_seed = strtoull(argv[++i], NULL, 10);
+        } else if (argv[i][0] != '-' && config_file == NULL) {
+            config_file = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    if (config_file == NULL) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    
+    SimulationConfig config = load_config(config_file);
+    SweepSpec spec;
+    if (!load_sweep(config_file, &spec)) {
+        return 1;
+    }
+    if (spec.num_axes == 0) {
+        fprintf(stderr, "Error: %s defines no sweep axes (use KEY=min..max:step)\n", config_file);
+        return 1;
+    }
+    
+    if (output_file != NULL) {
+        options.output = fopen(output_file, "w");
+        if (options.output == NULL) {
+            perror("Failed to open output file");
+            return 1;
+        }
+    }
+    
+    int workers = options.num_workers > 0 ? options.num_workers : default_worker_count();
+    fprintf(stderr, "Sweeping %lld points x %d runs over %d axes on %d workers (seed %" PRIu64 ")\n",
+            sweep_num_points(&spec), spec.runs_per_point, spec.num_axes, workers, options.base_seed);
+    
+    run_sweep(config, &spec, options);
+    
+    if (output_file != NULL) {
+        fclose(options.output);
+    }
+    return 0;
+}